@@ -0,0 +1,694 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * parseTx throughput benchmark.
+ * Every fixture (see gen_fixtures.py) is streamed through initTxContext/parseTx
+ * in APDU sized chunks, the same way handleSign receives it, and the signing
+ * digest is verified against the one computed by the host.
+ * Results are printed as one JSON object per line.
+ *
+ * Sweep mode (-s) re-feeds every fixture with each chunk size from 1 to 255
+ * bytes and with randomized splits (-r), and counts how often a chunk ends in
+ * the middle of a TLV header or of a field value, i.e. how often the stream
+ * state machine has to resume a partially received field.
+ *
+ * The parser is built with HAVE_HASH_STATS, every benchmark line reports
+ * how many transaction digest fragments were hashed in how many cx_hash calls.
+ *
+ * Dump mode (-d) prints every rendered argument screen instead of timings,
+ * so rendering changes can be diffed between builds.
+ *
+ * Fixtures are DER encoded streams unless -R is given, then they are plain
+ * EOS serialization (fixtures/raw).
+ *
+ * Manifest mode (-M) checks the manifest stored with every fixture and
+ * sets it on the context, so the stream is verified against it.
+ *
+ * Session mode (-C) takes the chain id out of every fixture and passes it
+ * with setTxChainId, as handleSign does for P1_SESSION_FIRST.
+ *
+ * Summary mode (-G) turns on setTxSummary, runs of transfers are then
+ * reviewed as one summary, dumped as "summary" screens.
+ *
+ * Reject mode (-E) expects every fixture to be malformed: at every chunk
+ * size parseTx has to fault before the stream is accepted. The digest line
+ * of these fixtures is not checked.
+ *
+ * Descriptors (-A, repeatable) are checked and stored as handleAbiDescriptor
+ * does, then passed to every parse with setTxDescriptors.
+ *
+ * Thread mode (-t) validates all fixtures at every chunk size on several
+ * threads at once, each with its own parser, to check that independent
+ * parses share no state.
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "os.h"
+#include "cx.h"
+#include "eos_stream.h"
+
+#define DEFAULT_ITERATIONS 2000
+#define DEFAULT_CHUNK_SIZE 150
+#define DEFAULT_SWEEP_ITERATIONS 50
+#define DEFAULT_THREAD_ROUNDS 4
+#define MAX_THREADS 64
+#define DEFAULT_RANDOM_SEED 0x5EED
+#define MAX_CHUNK_SIZE 255
+
+typedef struct fixture_t {
+    const char *name;
+    uint8_t *stream;
+    uint32_t length;
+    uint8_t digest[32];
+    uint8_t chainId[32];
+    uint8_t *manifest;
+    uint32_t manifestLength;
+} fixture_t;
+
+typedef struct splits_t {
+    uint8_t *sizes;
+    uint32_t count;
+} splits_t;
+
+typedef struct runStats_t {
+    uint32_t actions;
+    uint32_t arguments;
+    uint64_t actionReadyNs;
+    uint64_t printArgumentNs;
+    uint64_t prefetchNs;
+    uint32_t headerResumptions;
+    uint32_t fieldResumptions;
+} runStats_t;
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t G_random_state = DEFAULT_RANDOM_SEED;
+
+static uint32_t nextRandom(void) {
+    // xorshift32, reproducible across hosts
+    G_random_state ^= G_random_state << 13;
+    G_random_state ^= G_random_state >> 17;
+    G_random_state ^= G_random_state << 5;
+    return G_random_state;
+}
+
+/**
+ * Cuts the stream into chunks of chunkSize bytes, or into random chunks
+ * of 1..MAX_CHUNK_SIZE bytes when chunkSize is 0.
+*/
+static void makeSplits(uint32_t length, uint32_t chunkSize, splits_t *splits) {
+    splits->sizes = malloc(length);
+    splits->count = 0;
+    while (length != 0) {
+        uint32_t size = (chunkSize != 0 ? chunkSize : 1 + nextRandom() % MAX_CHUNK_SIZE);
+        if (size > length) {
+            size = length;
+        }
+        splits->sizes[splits->count++] = size;
+        length -= size;
+    }
+}
+
+static int hexToBytes(const char *hex, size_t hexLength, uint8_t *out) {
+    size_t i;
+    for (i = 0; i < hexLength / 2; ++i) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+            return -1;
+        }
+        out[i] = byte;
+    }
+    return 0;
+}
+
+static bool G_dump_screens;
+static bool G_session;
+static bool G_manifest;
+static bool G_summary;
+static bool G_reject;
+static txEncoding_e G_encoding = TX_ENCODING_TLV;
+// Read only once loaded, shared by all threads
+static abiDescriptorStore_t G_descriptors;
+static const abiDescriptorStore_t *G_descriptorStore;
+
+/**
+ * Store the hex encoded descriptor in the first line of path.
+*/
+static int loadDescriptor(const char *path) {
+    uint8_t buffer[ABI_DESCRIPTOR_SIZE];
+    abiDescriptor_t descriptor;
+    char *line = NULL;
+    size_t capacity = 0;
+    int result = -1;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    ssize_t length = getline(&line, &capacity, f);
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+        length--;
+    }
+    if (length == 2 * sizeof(buffer) && hexToBytes(line, length, buffer) == 0 &&
+        checkAbiDescriptor(buffer, sizeof(buffer), &descriptor)) {
+        uint8_t slot = abiDescriptorSlot(&G_descriptors, descriptor.contract, descriptor.action);
+        G_descriptors.slots[slot] = descriptor;
+        G_descriptors.used[slot] = ++G_descriptors.clock;
+        G_descriptorStore = &G_descriptors;
+        result = 0;
+    }
+    fclose(f);
+    free(line);
+    return result;
+}
+
+static int loadFixture(const char *path, fixture_t *fixture) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    char *line = NULL;
+    size_t capacity = 0;
+    ssize_t streamLength = getline(&line, &capacity, f);
+    if (streamLength <= 0) {
+        fclose(f);
+        free(line);
+        return -1;
+    }
+    while (streamLength > 0 && (line[streamLength - 1] == '\n' || line[streamLength - 1] == '\r')) {
+        streamLength--;
+    }
+    fixture->length = streamLength / 2;
+    fixture->stream = malloc(fixture->length);
+    int result = hexToBytes(line, streamLength, fixture->stream);
+
+    ssize_t digestLength = getline(&line, &capacity, f);
+    if (result == 0 && (digestLength < 64 || hexToBytes(line, 64, fixture->digest) != 0)) {
+        result = -1;
+    }
+
+    // Optional manifest line
+    ssize_t manifestLength = getline(&line, &capacity, f);
+    while (manifestLength > 0 && (line[manifestLength - 1] == '\n' || line[manifestLength - 1] == '\r')) {
+        manifestLength--;
+    }
+    fixture->manifestLength = (manifestLength > 0 ? manifestLength / 2 : 0);
+    fixture->manifest = malloc(fixture->manifestLength + 1);
+    if (result == 0 && hexToBytes(line, 2 * fixture->manifestLength, fixture->manifest) != 0) {
+        result = -1;
+    }
+    if (result == 0 && G_manifest && fixture->manifestLength == 0) {
+        result = -1;
+    }
+    free(line);
+    fclose(f);
+
+    if (result == 0 && G_session) {
+        // Chain id field, wrapped in a two byte DER header unless raw
+        uint32_t header = (G_encoding == TX_ENCODING_TLV ? 2 : 0);
+        uint32_t skip = header + sizeof(fixture->chainId);
+        if (fixture->length < skip) {
+            result = -1;
+        } else {
+            os_memmove(fixture->chainId, fixture->stream + header, sizeof(fixture->chainId));
+            fixture->length -= skip;
+            os_memmove(fixture->stream, fixture->stream + skip, fixture->length);
+        }
+    }
+
+    const char *name = strrchr(path, '/');
+    name = (name != NULL ? name + 1 : path);
+    char *base = strdup(name);
+    char *dot = strrchr(base, '.');
+    if (dot != NULL) {
+        *dot = 0;
+    }
+    fixture->name = base;
+    return result;
+}
+
+/**
+ * Screens are walked forward as on device: printArgument is what a button
+ * press waits for, the neighbours are prefetched once the screen is shown.
+*/
+static bool printArguments(txParser_t *parser, runStats_t *stats) {
+    txProcessingContent_t *content = &parser->content;
+    uint64_t start = nowNs();
+    while (prefetchArgument(&parser->context)) {
+    }
+    stats->prefetchNs += nowNs() - start;
+    for (uint8_t i = 0; i < content->argumentCount; ++i) {
+        start = nowNs();
+        if (!printArgument(i, &parser->context)) {
+            return false;
+        }
+        stats->printArgumentNs += nowNs() - start;
+        if (G_dump_screens) {
+            if (content->summaryState == SUMMARY_REVIEW) {
+                printf("summary [%u] %s: %s\n", i, content->arg.label, content->arg.data);
+            } else {
+                printf("%s.%s [%u] %s: %s\n", content->contract, content->action, i,
+                       content->arg.label, content->arg.data);
+            }
+        }
+        start = nowNs();
+        while (prefetchArgument(&parser->context)) {
+        }
+        stats->prefetchNs += nowNs() - start;
+    }
+    stats->arguments += content->argumentCount;
+    return true;
+}
+
+/**
+ * Streams one transaction through the parser. Actions are accepted as soon
+ * as they are ready, like a user pressing "Accept" on every screen.
+ * When stats is NULL no per event timing is done.
+*/
+static int runTransaction(txParser_t *parser, fixture_t *fixture, splits_t *splits, runStats_t *stats) {
+    txProcessingContext_t *context = &parser->context;
+    // Chunks are passed in a reused buffer, as G_io_apdu_buffer on device
+    uint8_t apdu[MAX_CHUNK_SIZE];
+    uint32_t offset = 0;
+    uint64_t eventStart = (stats != NULL ? nowNs() : 0);
+
+    initTxParser(parser, 1, G_encoding);
+    setTxDescriptors(context, G_descriptorStore);
+    setTxSummary(context, G_summary);
+    if (G_session) {
+        setTxChainId(context, fixture->chainId);
+    }
+    if (G_manifest) {
+        txManifest_t manifest;
+        if (!checkTxManifest(fixture->manifest, fixture->manifestLength, 1, G_descriptorStore, &manifest)) {
+            return -1;
+        }
+        setTxManifest(context, &manifest);
+    }
+
+    for (uint32_t i = 0; i < splits->count; ++i) {
+        uint32_t length = splits->sizes[i];
+        os_memmove(apdu, fixture->stream + offset, length);
+        parserStatus_e status = parseTx(context, apdu, length);
+        offset += length;
+
+        for (;;) {
+            if (status == STREAM_ACTION_READY || status == STREAM_SUMMARY_READY) {
+                if (stats != NULL) {
+                    stats->actionReadyNs += nowNs() - eventStart;
+                    stats->actions++;
+                    if (!printArguments(parser, stats)) {
+                        return -1;
+                    }
+                    eventStart = nowNs();
+                }
+            } else if (status != STREAM_CONFIRM_PROCESSING) {
+                break;
+            }
+            status = parseTx(context, NULL, 0);
+        }
+
+        if (status == STREAM_FINISHED) {
+            return (offset == fixture->length ? 0 : -1);
+        }
+        if (status != STREAM_PROCESSING) {
+            return -1;
+        }
+        if (stats != NULL) {
+            // Arguments must not refer to a chunk that has been answered
+            os_memset(apdu, 0xA5, length);
+
+            // Chunk ended, find out what the next one has to resume
+            if (context->tlvBufferPos != 0) {
+                stats->headerResumptions++;
+            } else if (context->processingField) {
+                stats->fieldResumptions++;
+            }
+        }
+    }
+    return -1;
+}
+
+static int verifyDigest(txParser_t *parser, fixture_t *fixture) {
+    uint8_t digest[32];
+    cx_hash(&parser->sha256.header, CX_LAST, digest, 0, digest, sizeof(digest));
+    return memcmp(digest, fixture->digest, sizeof(digest)) == 0 ? 0 : -1;
+}
+
+static int benchmarkFixture(fixture_t *fixture, uint32_t iterations, uint32_t chunkSize) {
+    txParser_t parser;
+    runStats_t stats;
+    splits_t splits;
+    uint32_t i;
+
+    makeSplits(fixture->length, chunkSize, &splits);
+    os_memset(&stats, 0, sizeof(stats));
+    if (runTransaction(&parser, fixture, &splits, &stats) != 0 || verifyDigest(&parser, fixture) != 0) {
+        fprintf(stderr, "%s: parsing failed or digest mismatch\n", fixture->name);
+        free(splits.sizes);
+        return -1;
+    }
+    uint32_t actions = stats.actions;
+    hashStats_t hashStats = parser.context.hashStats;
+
+    // Plain parsing, no per event timers
+    uint64_t start = nowNs();
+    for (i = 0; i < iterations; ++i) {
+        runTransaction(&parser, fixture, &splits, NULL);
+    }
+    uint64_t parseNs = nowNs() - start;
+
+    // Instrumented parsing: action ready latency and argument rendering
+    os_memset(&stats, 0, sizeof(stats));
+    for (i = 0; i < iterations; ++i) {
+        runTransaction(&parser, fixture, &splits, &stats);
+    }
+    free(splits.sizes);
+
+    double perTx = (double)parseNs / iterations;
+    printf("{\"fixture\":\"%s\",\"chunk\":%u,\"iterations\":%u,\"bytes\":%u,\"actions\":%u,"
+           "\"arguments\":%u,\"ns_per_tx\":%.1f,\"ns_per_byte\":%.3f,\"ns_per_action\":%.1f,"
+           "\"ns_per_action_ready\":%.1f,\"ns_per_argument\":%.1f,\"ns_per_prefetch\":%.1f,"
+           "\"hash_updates\":%u,\"hash_calls\":%u,\"hash_calls_saved\":%u}\n",
+           fixture->name, chunkSize, iterations, fixture->length, actions,
+           stats.arguments / iterations,
+           perTx,
+           perTx / fixture->length,
+           actions ? perTx / actions : 0.0,
+           stats.actions ? (double)stats.actionReadyNs / stats.actions : 0.0,
+           stats.arguments ? (double)stats.printArgumentNs / stats.arguments : 0.0,
+           stats.arguments ? (double)stats.prefetchNs / stats.arguments : 0.0,
+           hashStats.hashUpdates, hashStats.hashCalls, hashStats.hashUpdates - hashStats.hashCalls);
+    return 0;
+}
+
+/**
+ * Parse cost and resumption count for one way of splitting the stream.
+ * Randomized splits are reported with chunk 0 and their pattern number.
+*/
+static int sweepSplits(fixture_t *fixture, uint32_t iterations, uint32_t chunkSize, uint32_t pattern) {
+    txParser_t parser;
+    runStats_t stats;
+    splits_t splits;
+    uint32_t i;
+
+    makeSplits(fixture->length, chunkSize, &splits);
+    os_memset(&stats, 0, sizeof(stats));
+    if (runTransaction(&parser, fixture, &splits, &stats) != 0 || verifyDigest(&parser, fixture) != 0) {
+        fprintf(stderr, "%s: chunk %u pattern %u: parsing failed or digest mismatch\n",
+                fixture->name, chunkSize, pattern);
+        free(splits.sizes);
+        return -1;
+    }
+
+    uint64_t start = nowNs();
+    for (i = 0; i < iterations; ++i) {
+        runTransaction(&parser, fixture, &splits, NULL);
+    }
+    uint64_t parseNs = nowNs() - start;
+
+    printf("{\"fixture\":\"%s\",\"mode\":\"%s\",\"chunk\":%u,\"pattern\":%u,\"chunks\":%u,"
+           "\"bytes\":%u,\"ns_per_tx\":%.1f,\"ns_per_byte\":%.3f,\"ns_per_chunk\":%.1f,"
+           "\"header_resumptions\":%u,\"field_resumptions\":%u}\n",
+           fixture->name, chunkSize != 0 ? "sweep" : "random", chunkSize, pattern, splits.count,
+           fixture->length,
+           (double)parseNs / iterations,
+           (double)parseNs / iterations / fixture->length,
+           (double)parseNs / iterations / splits.count,
+           stats.headerResumptions, stats.fieldResumptions);
+    free(splits.sizes);
+    return 0;
+}
+
+static int sweepFixture(fixture_t *fixture, uint32_t iterations, uint32_t patterns) {
+    int result = 0;
+    for (uint32_t chunkSize = 1; chunkSize <= MAX_CHUNK_SIZE; ++chunkSize) {
+        result |= sweepSplits(fixture, iterations, chunkSize, 0);
+    }
+    for (uint32_t pattern = 1; pattern <= patterns; ++pattern) {
+        result |= sweepSplits(fixture, iterations, 0, pattern);
+    }
+    return result;
+}
+
+static int dumpFixture(fixture_t *fixture, uint32_t chunkSize) {
+    txParser_t parser;
+    runStats_t stats;
+    splits_t splits;
+
+    makeSplits(fixture->length, chunkSize, &splits);
+    os_memset(&stats, 0, sizeof(stats));
+    printf("# %s\n", fixture->name);
+    int result = runTransaction(&parser, fixture, &splits, &stats);
+    free(splits.sizes);
+    if (result != 0 || verifyDigest(&parser, fixture) != 0) {
+        fprintf(stderr, "%s: parsing failed or digest mismatch\n", fixture->name);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Malformed fixtures must fault, however the stream is split.
+*/
+static int rejectFixture(fixture_t *fixture) {
+    txParser_t parser;
+    uint32_t rejected = 0;
+
+    for (uint32_t chunkSize = 1; chunkSize <= MAX_CHUNK_SIZE; ++chunkSize) {
+        splits_t splits;
+        makeSplits(fixture->length, chunkSize, &splits);
+        // parseTx leaves a faulted context uninitialized
+        if (runTransaction(&parser, fixture, &splits, NULL) != 0 && parser.context.state == TLV_NONE) {
+            rejected++;
+        } else {
+            fprintf(stderr, "%s: chunk %u: malformed stream not rejected\n", fixture->name, chunkSize);
+        }
+        free(splits.sizes);
+    }
+    printf("{\"fixture\":\"%s\",\"mode\":\"reject\",\"chunks\":%u,\"rejected\":%u}\n",
+           fixture->name, MAX_CHUNK_SIZE, rejected);
+    return rejected == MAX_CHUNK_SIZE ? 0 : -1;
+}
+
+typedef struct validateJob_t {
+    fixture_t *fixtures;
+    uint32_t count;
+    uint32_t rounds;
+    uint32_t transactions;
+    uint32_t failures;
+} validateJob_t;
+
+static void *validateThread(void *arg) {
+    validateJob_t *job = (validateJob_t *)arg;
+    txParser_t parser;
+    // Counted locally, jobs of all threads share cache lines
+    uint32_t transactions = 0;
+    uint32_t failures = 0;
+
+    for (uint32_t round = 0; round < job->rounds; ++round) {
+        for (uint32_t i = 0; i < job->count; ++i) {
+            fixture_t *fixture = &job->fixtures[i];
+            for (uint32_t chunkSize = 1; chunkSize <= MAX_CHUNK_SIZE; ++chunkSize) {
+                splits_t splits;
+                makeSplits(fixture->length, chunkSize, &splits);
+                if (runTransaction(&parser, fixture, &splits, NULL) != 0 || verifyDigest(&parser, fixture) != 0) {
+                    failures++;
+                }
+                transactions++;
+                free(splits.sizes);
+            }
+        }
+    }
+    job->transactions = transactions;
+    job->failures = failures;
+    return NULL;
+}
+
+/**
+ * Every thread validates all fixtures at every chunk size, rounds times.
+ * Reports aggregate throughput and the number of failed validations.
+*/
+static int validateFixtures(fixture_t *fixtures, uint32_t count, uint32_t threads, uint32_t rounds) {
+    pthread_t ids[MAX_THREADS];
+    validateJob_t jobs[MAX_THREADS];
+    uint32_t transactions = 0;
+    uint32_t failures = 0;
+    uint32_t i;
+
+    uint64_t start = nowNs();
+    for (i = 0; i < threads; ++i) {
+        jobs[i] = (validateJob_t){ fixtures, count, rounds, 0, 0 };
+        if (pthread_create(&ids[i], NULL, validateThread, &jobs[i]) != 0) {
+            fprintf(stderr, "cannot start thread %u\n", i);
+            threads = i;
+            failures++;
+            break;
+        }
+    }
+    for (i = 0; i < threads; ++i) {
+        pthread_join(ids[i], NULL);
+        transactions += jobs[i].transactions;
+        failures += jobs[i].failures;
+    }
+    uint64_t elapsedNs = nowNs() - start;
+
+    printf("{\"mode\":\"threads\",\"threads\":%u,\"transactions\":%u,\"failures\":%u,"
+           "\"ns_per_tx\":%.1f,\"tx_per_second\":%.0f}\n",
+           threads, transactions, failures,
+           transactions ? (double)elapsedNs / transactions : 0.0,
+           elapsedNs ? transactions * 1e9 / elapsedNs : 0.0);
+    return failures == 0 ? 0 : -1;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-R|-N] [-C] [-M] [-G] [-A descriptor.hex] [-n iterations] [-c chunk size] fixture.hex...\n"
+                    "       %s -s [-n iterations] [-r random patterns] [-S seed] fixture.hex...\n"
+                    "       %s -d [-c chunk size] fixture.hex...\n"
+                    "       %s -t threads [-n rounds] fixture.hex...\n"
+                    "       %s -E [-R|-N] fixture.hex...\n",
+                    name, name, name, name, name);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = 0;
+    uint32_t chunkSize = DEFAULT_CHUNK_SIZE;
+    uint32_t patterns = 0;
+    uint32_t threads = 0;
+    bool sweep = false;
+    int opt;
+    int result = 0;
+
+    while ((opt = getopt(argc, argv, "n:c:sr:S:dt:RNCMGEA:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            iterations = strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            chunkSize = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            sweep = true;
+            break;
+        case 'r':
+            patterns = strtoul(optarg, NULL, 0);
+            break;
+        case 'S':
+            G_random_state = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            G_dump_screens = true;
+            break;
+        case 'R':
+            G_encoding = TX_ENCODING_RAW;
+            break;
+        case 'N':
+            G_encoding = TX_ENCODING_RAW_NAMES;
+            break;
+        case 'C':
+            G_session = true;
+            break;
+        case 'M':
+            G_manifest = true;
+            break;
+        case 'G':
+            G_summary = true;
+            break;
+        case 'E':
+            G_reject = true;
+            break;
+        case 'A':
+            if (loadDescriptor(optarg) != 0) {
+                fprintf(stderr, "%s: cannot load descriptor\n", optarg);
+                return 1;
+            }
+            break;
+        case 't':
+            threads = strtoul(optarg, NULL, 0);
+            if (threads == 0 || threads > MAX_THREADS) {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iterations == 0) {
+        iterations = (threads != 0 ? DEFAULT_THREAD_ROUNDS : sweep ? DEFAULT_SWEEP_ITERATIONS : DEFAULT_ITERATIONS);
+    }
+    if (optind == argc || chunkSize == 0 || chunkSize > MAX_CHUNK_SIZE || G_random_state == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (threads != 0) {
+        uint32_t count = argc - optind;
+        fixture_t *fixtures = calloc(count, sizeof(fixture_t));
+        for (uint32_t i = 0; i < count; ++i) {
+            if (loadFixture(argv[optind + i], &fixtures[i]) != 0) {
+                fprintf(stderr, "%s: cannot load fixture\n", argv[optind + i]);
+                return 1;
+            }
+        }
+        result = (validateFixtures(fixtures, count, threads, iterations) != 0 ? 1 : 0);
+        for (uint32_t i = 0; i < count; ++i) {
+            free(fixtures[i].stream);
+            free(fixtures[i].manifest);
+            free((void *)fixtures[i].name);
+        }
+        free(fixtures);
+        return result;
+    }
+
+    for (int i = optind; i < argc; ++i) {
+        fixture_t fixture;
+        if (loadFixture(argv[i], &fixture) != 0) {
+            fprintf(stderr, "%s: cannot load fixture\n", argv[i]);
+            return 1;
+        }
+        if (G_reject) {
+            if (rejectFixture(&fixture) != 0) {
+                result = 1;
+            }
+        } else if (G_dump_screens) {
+            if (dumpFixture(&fixture, chunkSize) != 0) {
+                result = 1;
+            }
+        } else if (sweep) {
+            if (sweepFixture(&fixture, iterations, patterns) != 0) {
+                result = 1;
+            }
+        } else if (benchmarkFixture(&fixture, iterations, chunkSize) != 0) {
+            result = 1;
+        }
+        free(fixture.stream);
+        free(fixture.manifest);
+        free((void *)fixture.name);
+    }
+    return result;
+}
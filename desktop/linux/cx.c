@@ -0,0 +1,326 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "cx.h"
+#include <string.h>
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t RIPEMD160_IV[5] = {
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+};
+
+static const uint8_t RIPEMD160_R[80] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+    3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+    1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+    4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+};
+
+static const uint8_t RIPEMD160_RP[80] = {
+    5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+    6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+    15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+    8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+    12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+};
+
+static const uint8_t RIPEMD160_S[80] = {
+    11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+    7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+    11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+    11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+    9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+};
+
+static const uint8_t RIPEMD160_SP[80] = {
+    8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+    9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+    9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+    15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+    8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+};
+
+static const uint32_t RIPEMD160_K[5] = {
+    0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e
+};
+
+static const uint32_t RIPEMD160_KP[5] = {
+    0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000
+};
+
+static uint32_t read_be32(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t read_le32(const unsigned char *p) {
+    return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+static void write_be32(unsigned char *p, uint32_t v) {
+    p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+static void write_le32(unsigned char *p, uint32_t v) {
+    p[3] = v >> 24; p[2] = v >> 16; p[1] = v >> 8; p[0] = v;
+}
+
+static void sha256_compress(cx_sha256_t *ctx, const unsigned char *block) {
+    uint32_t w[64];
+    uint32_t s[8];
+    uint32_t i;
+
+    memcpy(s, ctx->acc, sizeof(s));
+    for (i = 0; i < 16; ++i) {
+        w[i] = read_be32(block + 4 * i);
+    }
+    for (i = 16; i < 64; ++i) {
+        uint32_t s0 = ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = s[0], b = s[1], c = s[2], d = s[3];
+    uint32_t e = s[4], f = s[5], g = s[6], h = s[7];
+    for (i = 0; i < 64; ++i) {
+        uint32_t t1 = h + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25)) +
+                      ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+        uint32_t t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22)) +
+                      ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+    memcpy(ctx->acc, s, sizeof(s));
+}
+
+static uint32_t ripemd160_f(uint32_t j, uint32_t x, uint32_t y, uint32_t z) {
+    switch (j / 16) {
+    case 0: return x ^ y ^ z;
+    case 1: return (x & y) | (~x & z);
+    case 2: return (x | ~y) ^ z;
+    case 3: return (x & z) | (y & ~z);
+    default: return x ^ (y | ~z);
+    }
+}
+
+static void ripemd160_compress(cx_ripemd160_t *ctx, const unsigned char *block) {
+    uint32_t x[16];
+    uint32_t h[5];
+    uint32_t j;
+
+    memcpy(h, ctx->acc, sizeof(h));
+    for (j = 0; j < 16; ++j) {
+        x[j] = read_le32(block + 4 * j);
+    }
+
+    uint32_t al = h[0], bl = h[1], cl = h[2], dl = h[3], el = h[4];
+    uint32_t ar = h[0], br = h[1], cr = h[2], dr = h[3], er = h[4];
+    for (j = 0; j < 80; ++j) {
+        uint32_t t = al + ripemd160_f(j, bl, cl, dl) + x[RIPEMD160_R[j]] + RIPEMD160_K[j / 16];
+        t = ROTL32(t, RIPEMD160_S[j]) + el;
+        al = el; el = dl; dl = ROTL32(cl, 10); cl = bl; bl = t;
+
+        t = ar + ripemd160_f(79 - j, br, cr, dr) + x[RIPEMD160_RP[j]] + RIPEMD160_KP[j / 16];
+        t = ROTL32(t, RIPEMD160_SP[j]) + er;
+        ar = er; er = dr; dr = ROTL32(cr, 10); cr = br; br = t;
+    }
+
+    uint32_t t = h[1] + cl + dr;
+    h[1] = h[2] + dl + er;
+    h[2] = h[3] + el + ar;
+    h[3] = h[4] + al + br;
+    h[4] = h[0] + bl + cr;
+    h[0] = t;
+    memcpy(ctx->acc, h, sizeof(h));
+}
+
+int cx_sha256_init(cx_sha256_t *hash) {
+    memset(hash, 0, sizeof(cx_sha256_t));
+    hash->header.algo = CX_SHA256;
+    memcpy(hash->acc, SHA256_IV, sizeof(SHA256_IV));
+    return CX_SHA256;
+}
+
+int cx_ripemd160_init(cx_ripemd160_t *hash) {
+    memset(hash, 0, sizeof(cx_ripemd160_t));
+    hash->header.algo = CX_RIPEMD160;
+    memcpy(hash->acc, RIPEMD160_IV, sizeof(RIPEMD160_IV));
+    return CX_RIPEMD160;
+}
+
+/**
+ * Both supported digests share the same 64 byte block structure, they only
+ * differ in compression function and in the byte order of the length and
+ * of the output words.
+*/
+static int hash_update(cx_hash_t *hash, const unsigned char *in, unsigned int len,
+                       unsigned int *blen, unsigned char *block) {
+    while (len != 0) {
+        unsigned int chunk = 64 - *blen;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(block + *blen, in, chunk);
+        *blen += chunk;
+        in += chunk;
+        len -= chunk;
+
+        if (*blen == 64) {
+            if (hash->algo == CX_SHA256) {
+                sha256_compress((cx_sha256_t *)hash, block);
+            } else {
+                ripemd160_compress((cx_ripemd160_t *)hash, block);
+            }
+            hash->counter++;
+            *blen = 0;
+        }
+    }
+    return 0;
+}
+
+static int hash_final(cx_hash_t *hash, unsigned int *blen, unsigned char *block,
+                      unsigned char *out, unsigned int out_len) {
+    uint64_t bits = ((uint64_t)hash->counter * 64 + *blen) * 8;
+    unsigned char pad[72];
+    unsigned int padLength = (*blen < 56 ? 56 : 120) - *blen;
+    unsigned int i;
+
+    memset(pad, 0, sizeof(pad));
+    pad[0] = 0x80;
+    for (i = 0; i < 8; ++i) {
+        if (hash->algo == CX_SHA256) {
+            pad[padLength + i] = (unsigned char)(bits >> (56 - 8 * i));
+        } else {
+            pad[padLength + i] = (unsigned char)(bits >> (8 * i));
+        }
+    }
+    hash_update(hash, pad, padLength + 8, blen, block);
+
+    unsigned char digest[32];
+    unsigned int digestLength;
+    if (hash->algo == CX_SHA256) {
+        uint32_t s[8];
+        memcpy(s, ((cx_sha256_t *)hash)->acc, sizeof(s));
+        for (i = 0; i < 8; ++i) {
+            write_be32(digest + 4 * i, s[i]);
+        }
+        digestLength = 32;
+    } else {
+        uint32_t h[5];
+        memcpy(h, ((cx_ripemd160_t *)hash)->acc, sizeof(h));
+        for (i = 0; i < 5; ++i) {
+            write_le32(digest + 4 * i, h[i]);
+        }
+        digestLength = 20;
+    }
+
+    if (out != NULL) {
+        memcpy(out, digest, out_len < digestLength ? out_len : digestLength);
+    }
+    return digestLength;
+}
+
+int cx_hash(cx_hash_t *hash, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len) {
+    unsigned int *blen;
+    unsigned char *block;
+
+    if (hash->algo == CX_SHA256) {
+        blen = &((cx_sha256_t *)hash)->blen;
+        block = ((cx_sha256_t *)hash)->block;
+    } else if (hash->algo == CX_RIPEMD160) {
+        blen = &((cx_ripemd160_t *)hash)->blen;
+        block = ((cx_ripemd160_t *)hash)->block;
+    } else {
+        return 0;
+    }
+
+    hash_update(hash, in, len, blen, block);
+    if (mode & CX_LAST) {
+        return hash_final(hash, blen, block, out, out_len);
+    }
+    return 0;
+}
+
+static void hmac_sha256_start(cx_hmac_sha256_t *hmac) {
+    unsigned char ipad[64];
+    unsigned int i;
+
+    for (i = 0; i < sizeof(ipad); ++i) {
+        ipad[i] = hmac->key[i] ^ 0x36;
+    }
+    cx_sha256_init(&hmac->hash_ctx);
+    cx_hash(&hmac->hash_ctx.header, 0, ipad, sizeof(ipad), NULL, 0);
+}
+
+int cx_hmac_sha256_init(cx_hmac_sha256_t *hmac, const unsigned char *key, unsigned int key_len) {
+    memset(hmac->key, 0, sizeof(hmac->key));
+    if (key_len > sizeof(hmac->key)) {
+        cx_sha256_t keyHash;
+        cx_sha256_init(&keyHash);
+        cx_hash(&keyHash.header, CX_LAST, key, key_len, hmac->key, 32);
+    } else if (key_len != 0) {
+        memcpy(hmac->key, key, key_len);
+    }
+    hmac_sha256_start(hmac);
+    return CX_SHA256;
+}
+
+int cx_hmac(cx_hmac_t *hmac, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *mac, unsigned int mac_len) {
+    cx_hash(&hmac->hash_ctx.header, 0, in, len, NULL, 0);
+    if (!(mode & CX_LAST)) {
+        return 0;
+    }
+
+    unsigned char inner[32];
+    unsigned char opad[64];
+    unsigned int i;
+
+    cx_hash(&hmac->hash_ctx.header, CX_LAST, NULL, 0, inner, sizeof(inner));
+    for (i = 0; i < sizeof(opad); ++i) {
+        opad[i] = hmac->key[i] ^ 0x5c;
+    }
+    cx_sha256_init(&hmac->hash_ctx);
+    cx_hash(&hmac->hash_ctx.header, 0, opad, sizeof(opad), NULL, 0);
+    cx_hash(&hmac->hash_ctx.header, CX_LAST, inner, sizeof(inner), inner, sizeof(inner));
+    memcpy(mac, inner, mac_len < sizeof(inner) ? mac_len : sizeof(inner));
+
+    // Keyed state is restored, the same way the SDK does without CX_NO_REINIT
+    hmac_sha256_start(hmac);
+    return 32;
+}
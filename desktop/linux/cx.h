@@ -0,0 +1,73 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HOST_CX_H__
+#define __HOST_CX_H__
+
+/**
+ * Portable replacement of the BOLOS cx_* hashing API used by the parser core.
+ * Structure layouts and function signatures follow the SDK, so the sources
+ * in src/ compile unchanged on the host.
+*/
+
+#include <stdint.h>
+
+#define CX_LAST (1 << 0)
+
+typedef enum cx_md_e {
+    CX_NONE,
+    CX_RIPEMD160,
+    CX_SHA224,
+    CX_SHA256,
+} cx_md_t;
+
+typedef struct cx_hash_header_s {
+    cx_md_t algo;
+    unsigned int counter;
+} cx_hash_t;
+
+typedef struct cx_sha256_s {
+    cx_hash_t header;
+    unsigned int blen;
+    unsigned char block[64];
+    unsigned char acc[8 * 4];
+} cx_sha256_t;
+
+typedef struct cx_ripemd160_s {
+    cx_hash_t header;
+    unsigned int blen;
+    unsigned char block[64];
+    unsigned char acc[5 * 4];
+} cx_ripemd160_t;
+
+typedef struct cx_hmac_sha256_s {
+    unsigned char key[64];
+    cx_sha256_t hash_ctx;
+} cx_hmac_sha256_t;
+
+typedef cx_hmac_sha256_t cx_hmac_t;
+
+int cx_sha256_init(cx_sha256_t *hash);
+int cx_ripemd160_init(cx_ripemd160_t *hash);
+int cx_hash(cx_hash_t *hash, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len);
+
+int cx_hmac_sha256_init(cx_hmac_sha256_t *hmac, const unsigned char *key, unsigned int key_len);
+int cx_hmac(cx_hmac_t *hmac, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *mac, unsigned int mac_len);
+
+#endif // __HOST_CX_H__
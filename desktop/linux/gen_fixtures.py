@@ -0,0 +1,200 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+Encodes test/*.json transactions the same way signTransaction.py does and
+stores them as benchmark fixtures: first line is the signing stream, second
+line is the expected signing digest, third line the pre-flight manifest
+(empty if the transaction has too many actions for one), all hex encoded. DER encoded streams
+go to fixtures/, plain serialization (signTransaction.py --raw) to
+fixtures/raw/ and plain serialization with name references
+(signTransaction.py --names) to fixtures/names/.
+
+Malformed transfers of test/transaction.json, with a memo length the
+device must reject, go to fixtures/rejected/ in the same layout (bench -E).
+
+Every action of test/abi/<contract>.json is compiled into an uploadable
+descriptor, fixtures/descriptors/<contract>.<action>.hex (bench -A).
+"""
+
+import argparse
+import binascii
+import contextlib
+import glob
+import hashlib
+import io
+import json
+import os
+import sys
+import time
+import types
+
+sys.dont_write_bytecode = True
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(ROOT, '..', '..', 'test'))
+sys.path.insert(0, os.path.join(ROOT, '..', '..', 'src'))
+
+
+class OctetStringEncoder:
+    """Subset of asn1.Encoder used by eosBase: DER octet strings only."""
+
+    def start(self):
+        self.buffer = b''
+
+    def write(self, value, number):
+        length = len(value)
+        if length < 0x80:
+            header = bytes([number, length])
+        else:
+            size = length.to_bytes((length.bit_length() + 7) // 8, 'big')
+            header = bytes([number, 0x80 | len(size)]) + size
+        self.buffer += header + value
+
+    def output(self):
+        return self.buffer
+
+
+def b58decode(value):
+    alphabet = '123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz'
+    number = 0
+    for c in value:
+        number = number * 58 + alphabet.index(c)
+    pad = len(value) - len(value.lstrip('1'))
+    return b'\0' * pad + number.to_bytes((number.bit_length() + 7) // 8, 'big')
+
+
+# The generator only needs DER octet strings and base58 decoding, so do not
+# require python-asn1/base58 on build machines.
+try:
+    import asn1
+except ImportError:
+    sys.modules['asn1'] = types.SimpleNamespace(
+        Encoder=OctetStringEncoder, Numbers=types.SimpleNamespace(OctetString=0x04))
+try:
+    import base58
+except ImportError:
+    sys.modules['base58'] = types.SimpleNamespace(b58decode=b58decode)
+
+from eosBase import Transaction
+import gen_actions
+
+
+def signing_digest(tx):
+    sha = hashlib.sha256()
+    sha.update(tx.chain_id)
+    sha.update(tx.expiration)
+    sha.update(tx.ref_block_num)
+    sha.update(tx.ref_block_prefix)
+    sha.update(tx.net_usage_words)
+    sha.update(tx.max_cpu_usage_ms)
+    sha.update(tx.delay_sec)
+    sha.update(tx.ctx_free_actions_size)
+    sha.update(tx.actions_size)
+    for action in tx.actions:
+        sha.update(action.account)
+        sha.update(action.name)
+        sha.update(action.auth_size)
+        for (actor, permission) in action.auth:
+            sha.update(actor)
+            sha.update(permission)
+        sha.update(action.data_size)
+        sha.update(action.data)
+    sha.update(tx.tx_ext)
+    sha.update(tx.cfd)
+    return sha.digest()
+
+
+# Memo lengths above the chain limit, the second one followed by a few bytes
+# as if the length were 3
+REJECTED_MEMOS = (
+    ('transaction_memo_65536', 0x10000, b''),
+    ('transaction_memo_65539', 0x10003, b'AAA'),
+)
+
+
+def encode(obj, patch=None):
+    with contextlib.redirect_stdout(io.StringIO()):
+        tx = Transaction.parse(obj)
+        if patch is not None:
+            patch(tx)
+        return (tx, (b''.join(tx.encode2()), b''.join(tx.encode_raw()), b''.join(tx.encode_raw_names())),
+                tx.manifest() or b'')
+
+
+def write_fixtures(output, name, tx, streams, manifest):
+    digest = signing_digest(tx)
+    directories = (output, os.path.join(output, 'raw'), os.path.join(output, 'names'))
+    for (directory, data) in zip(directories, streams):
+        if not os.path.isdir(directory):
+            os.makedirs(directory)
+        with open(os.path.join(directory, name + '.hex'), 'w') as f:
+            f.write(binascii.hexlify(data).decode() + '\n')
+            f.write(binascii.hexlify(digest).decode() + '\n')
+            f.write(binascii.hexlify(manifest).decode() + '\n')
+    print(name)
+
+
+def patch_memo(length, memo):
+    def patch(tx):
+        # Transfer data: from, to and quantity, then the memo
+        action = tx.actions[0]
+        action.data = action.data[:2 * 8 + 16] + Transaction.pack_fc_uint(length) + memo
+        action.data_size = Transaction.pack_fc_uint(len(action.data))
+    return patch
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--input', default=os.path.join(ROOT, '..', '..', 'test'),
+                        help="Directory with transactions in JSON format")
+    parser.add_argument('--output', default=os.path.join(ROOT, 'fixtures'),
+                        help="Fixtures directory")
+    args = parser.parse_args()
+
+    # Expiration is converted with local time, keep fixtures reproducible
+    os.environ['TZ'] = 'UTC'
+    time.tzset()
+
+    for path in sorted(glob.glob(os.path.join(args.input, 'transaction*.json'))):
+        with open(path) as f:
+            obj = json.load(f)
+        name = os.path.splitext(os.path.basename(path))[0]
+        write_fixtures(args.output, name, *encode(obj))
+
+    with open(os.path.join(args.input, 'transaction.json')) as f:
+        obj = json.load(f)
+    for (name, length, memo) in REJECTED_MEMOS:
+        write_fixtures(os.path.join(args.output, 'rejected'), name, *encode(obj, patch_memo(length, memo)))
+
+    descriptors_output = os.path.join(args.output, 'descriptors')
+    if not os.path.isdir(descriptors_output):
+        os.makedirs(descriptors_output)
+    for path in sorted(glob.glob(os.path.join(args.input, 'abi', '*.json'))):
+        contract = os.path.splitext(os.path.basename(path))[0]
+        with open(path) as f:
+            actions = [action['name'] for action in json.load(f)['actions']]
+        for action in actions:
+            name = '%s.%s' % (contract, action)
+            with open(os.path.join(descriptors_output, name + '.hex'), 'w') as f:
+                f.write(gen_actions.descriptor(path, contract, action).hex() + '\n')
+            print(name)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,44 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "os.h"
+#include <stdlib.h>
+
+// Per thread, so SDK style TRY blocks in host tools do not unwind into
+// another thread's frames
+static __thread try_context_t *G_try_last_open_context;
+
+try_context_t *try_context_get(void) {
+    return G_try_last_open_context;
+}
+
+try_context_t *try_context_set(try_context_t *context) {
+    try_context_t *previous = G_try_last_open_context;
+    G_try_last_open_context = context;
+    return previous;
+}
+
+void os_longjmp(unsigned int exception) {
+    try_context_t *context = G_try_last_open_context;
+    if (context == NULL) {
+        fprintf(stderr, "Unhandled exception 0x%04x\n", exception);
+        abort();
+    }
+    // Unwinding pops the context, exactly as the SDK does
+    G_try_last_open_context = context->previous;
+    longjmp(context->jmp_buf, exception);
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HOST_OS_H__
+#define __HOST_OS_H__
+
+/**
+ * Portable replacement of the BOLOS os.h subset used by the parser core.
+ * Exceptions follow the SDK model: every TRY block registers a context
+ * which THROW unwinds to with longjmp.
+*/
+
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "cx.h"
+
+#define EXCEPTION 1
+#define INVALID_PARAMETER 2
+#define EXCEPTION_OVERFLOW 3
+#define EXCEPTION_SECURITY 4
+#define INVALID_STATE 9
+#define EXCEPTION_IO_RESET 16
+
+typedef unsigned short exception_t;
+
+typedef struct try_context_s {
+    jmp_buf jmp_buf;
+    struct try_context_s *previous;
+    exception_t ex;
+} try_context_t;
+
+try_context_t *try_context_get(void);
+try_context_t *try_context_set(try_context_t *context);
+void os_longjmp(unsigned int exception) __attribute__((noreturn));
+
+#define BEGIN_TRY_L(L)                                                         \
+    {                                                                          \
+        try_context_t __try##L;
+
+#define TRY_L(L)                                                               \
+        __try##L.ex = setjmp(__try##L.jmp_buf);                                \
+        if (__try##L.ex == 0) {                                                \
+            __try##L.previous = try_context_set(&__try##L);
+
+#define CATCH_L(L, x)                                                          \
+            goto __FINALLY##L;                                                 \
+        } else if (__try##L.ex == x) {                                         \
+            __try##L.ex = 0;                                                   \
+            try_context_set(__try##L.previous);
+
+#define CATCH_OTHER_L(L, e)                                                    \
+            goto __FINALLY##L;                                                 \
+        } else {                                                               \
+            exception_t e;                                                     \
+            e = __try##L.ex;                                                   \
+            __try##L.ex = 0;                                                   \
+            try_context_set(__try##L.previous);
+
+#define CATCH_ALL_L(L)                                                         \
+            goto __FINALLY##L;                                                 \
+        } else {                                                               \
+            __try##L.ex = 0;                                                   \
+            try_context_set(__try##L.previous);
+
+#define FINALLY_L(L)                                                           \
+            goto __FINALLY##L;                                                 \
+        }                                                                      \
+        __FINALLY##L:                                                          \
+        if (try_context_get() == &__try##L) {                                  \
+            try_context_set(__try##L.previous);                                \
+        }
+
+#define END_TRY_L(L)                                                           \
+        if (__try##L.ex != 0) {                                                \
+            os_longjmp(__try##L.ex);                                           \
+        }                                                                      \
+    }
+
+#define BEGIN_TRY BEGIN_TRY_L(_)
+#define TRY TRY_L(_)
+#define CATCH(x) CATCH_L(_, x)
+#define CATCH_OTHER(e) CATCH_OTHER_L(_, e)
+#define CATCH_ALL CATCH_ALL_L(_)
+#define FINALLY FINALLY_L(_)
+#define END_TRY END_TRY_L(_)
+
+#define THROW(x) os_longjmp(x)
+
+#ifdef HAVE_PRINTF
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+
+#define os_memset memset
+#define os_memmove memmove
+#define os_memcmp memcmp
+
+#define PIC(x) (x)
+
+#endif // __HOST_OS_H__
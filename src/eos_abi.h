@@ -0,0 +1,62 @@
+/**
+ * Generated by gen_actions.py from eos_actions.spec, do not edit.
+ * Bytecode of ABI described actions and the fields they display.
+*/
+
+static const argumentField_t abiFields[] = {
+    { "Bidder", parseNameField },
+    { "Newname", parseNameField },
+    { "Bid", parseAssetField },
+    { "Owner", parseNameField },
+    { "Producer", parseNameField },
+    { "Producer key", parsePublicKeyField },
+    { "Url", parseStringField },
+    { "Location", parseUint16Field },
+    { "Schedule #%d producer name", parseNameField },
+    { "Schedule #%d block signing key", parsePublicKeyField },
+    { "Proposer", parseNameField },
+    { "Proposal name", parseNameField },
+    { "Level", parsePermissionField },
+    { "Canceler", parseNameField },
+    { "Executer", parseNameField },
+};
+
+static const uint8_t abiProgram[] = {
+    // eosio::bidname, offset 0
+    ABI_OP_FIXED, 8, FIELD_ABI + 0,
+    ABI_OP_FIXED, 8, FIELD_ABI + 1,
+    ABI_OP_FIXED, 16, FIELD_ABI + 2,
+    ABI_OP_END,
+    // eosio::claimrewards, offset 10
+    ABI_OP_FIXED, 8, FIELD_ABI + 3,
+    ABI_OP_END,
+    // eosio::regproducer, offset 14
+    ABI_OP_FIXED, 8, FIELD_ABI + 4,
+    ABI_OP_SKIP, 1,
+    ABI_OP_FIXED, 33, FIELD_ABI + 5,
+    ABI_OP_STRING, FIELD_ABI + 6,
+    ABI_OP_FIXED, 2, FIELD_ABI + 7,
+    ABI_OP_END,
+    // eosio::setprods, offset 28
+    ABI_OP_VECTOR, 8,
+    ABI_OP_FIXED, 8, FIELD_ABI + 8,
+    ABI_OP_SKIP, 1,
+    ABI_OP_FIXED, 33, FIELD_ABI + 9,
+    ABI_OP_LOOP, 8,
+    ABI_OP_END,
+    // eosio.msig::approve, offset 41
+    ABI_OP_FIXED, 8, FIELD_ABI + 10,
+    ABI_OP_FIXED, 8, FIELD_ABI + 11,
+    ABI_OP_FIXED, 16, FIELD_ABI + 12,
+    ABI_OP_END,
+    // eosio.msig::cancel, offset 51
+    ABI_OP_FIXED, 8, FIELD_ABI + 10,
+    ABI_OP_FIXED, 8, FIELD_ABI + 11,
+    ABI_OP_FIXED, 8, FIELD_ABI + 13,
+    ABI_OP_END,
+    // eosio.msig::exec, offset 61
+    ABI_OP_FIXED, 8, FIELD_ABI + 10,
+    ABI_OP_FIXED, 8, FIELD_ABI + 11,
+    ABI_OP_FIXED, 8, FIELD_ABI + 14,
+    ABI_OP_END,
+};
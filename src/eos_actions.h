@@ -0,0 +1,30 @@
+/**
+ * Generated by gen_actions.py from eos_actions.spec, do not edit.
+ * Sorted by contract, then action.
+*/
+
+#define ACTION_REGISTRY_SIZE 21
+
+static const actionEntry_t actionRegistry[ACTION_REGISTRY_SIZE] = {
+    { 0x0000000000000000, 0xCDCD3C2D57000000, decodeTokenTransfer, 0 }, // *::transfer
+    { 0x5530EA0000000000, 0x3B93334940000000, decodeAbi, 0 }, // eosio::bidname
+    { 0x5530EA0000000000, 0x3EBD734800000000, decodeBuyRam, 0 }, // eosio::buyram
+    { 0x5530EA0000000000, 0x3EBD7348FECAB000, decodeBuyRamBytes, 0 }, // eosio::buyrambytes
+    { 0x5530EA0000000000, 0x444CE95D5C35D380, decodeAbi, 10 }, // eosio::claimrewards
+    { 0x5530EA0000000000, 0x4AA2A61B2A3F0000, decodeDelegate, 0 }, // eosio::delegatebw
+    { 0x5530EA0000000000, 0x4AA2ACA8DACB4000, decodeDeleteAuth, 0 }, // eosio::deleteauth
+    { 0x5530EA0000000000, 0x8BA7036B2D000000, decodeLinkAuth, 0 }, // eosio::linkauth
+    { 0x5530EA0000000000, 0x9AB864229A9E4000, decodeNewAccount, 0 }, // eosio::newaccount
+    { 0x5530EA0000000000, 0xBA97A9A400000000, decodeRefund, 0 }, // eosio::refund
+    { 0x5530EA0000000000, 0xBA995BD13A42AE00, decodeAbi, 14 }, // eosio::regproducer
+    { 0x5530EA0000000000, 0xC2A31B9A40000000, decodeSellRam, 0 }, // eosio::sellram
+    { 0x5530EA0000000000, 0xC2B35BD138000000, decodeAbi, 28 }, // eosio::setprods
+    { 0x5530EA0000000000, 0xD4D2A8A986CA8FC0, decodeUndelegate, 0 }, // eosio::undelegatebw
+    { 0x5530EA0000000000, 0xD4E2E9C0DACB4000, decodeUnlinkAuth, 0 }, // eosio::unlinkauth
+    { 0x5530EA0000000000, 0xD5526CA8DACB4000, decodeUpdateAuth, 0 }, // eosio::updateauth
+    { 0x5530EA0000000000, 0xDD32AADE89D21570, decodeVoteProducer, 0 }, // eosio::voteproducer
+    { 0x5530EA0258730000, 0x356B7A6D40000000, decodeAbi, 41 }, // eosio.msig::approve
+    { 0x5530EA0258730000, 0x41A6854400000000, decodeAbi, 51 }, // eosio.msig::cancel
+    { 0x5530EA0258730000, 0x5754800000000000, decodeAbi, 61 }, // eosio.msig::exec
+    { 0x5530EA0258730000, 0xD4CD5ADE9B500000, decodeAbi, 41 }, // eosio.msig::unapprove
+};
@@ -0,0 +1,30 @@
+# Supported actions: contract, action and the decoder of its data.
+# Contract * matches the action of any contract.
+# gen_actions.py turns this into the sorted registry eos_actions.h,
+# committed, run make generate after changing this file. Decoder abi:<file>
+# compiles the action from a contract ABI, relative to this file.
+
+*           transfer        decodeTokenTransfer
+
+eosio       delegatebw      decodeDelegate
+eosio       undelegatebw    decodeUndelegate
+eosio       refund          decodeRefund
+eosio       buyram          decodeBuyRam
+eosio       buyrambytes     decodeBuyRamBytes
+eosio       sellram         decodeSellRam
+eosio       voteproducer    decodeVoteProducer
+eosio       updateauth      decodeUpdateAuth
+eosio       deleteauth      decodeDeleteAuth
+eosio       linkauth        decodeLinkAuth
+eosio       unlinkauth      decodeUnlinkAuth
+eosio       newaccount      decodeNewAccount
+
+# Decoded by the ABI bytecode interpreter
+eosio       bidname         abi:abi/eosio.json
+eosio       claimrewards    abi:abi/eosio.json
+eosio       regproducer     abi:abi/eosio.json
+eosio       setprods        abi:abi/eosio.json
+eosio.msig  approve         abi:abi/eosio.msig.json
+eosio.msig  unapprove       abi:abi/eosio.msig.json
+eosio.msig  cancel          abi:abi/eosio.msig.json
+eosio.msig  exec            abi:abi/eosio.msig.json
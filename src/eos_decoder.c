@@ -0,0 +1,388 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "eos_decoder.h"
+#include "eos_parse_abi.h"
+#include "eos_types.h"
+#include "eos_utils.h"
+#include "os.h"
+#include <stdbool.h>
+#include <string.h>
+
+static bool parseNullField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+    uint8_t null[] = {4, 'N', 'U', 'L', 'L'};
+    return parseStringField(null, sizeof(null), fieldName, arg, read, written);
+}
+
+static bool parseYesField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+    printString("Yes", fieldName, arg);
+    return true;
+}
+
+static bool parseKeyField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+    // Skip key Type
+    return parsePublicKeyField(in + 1, inLength - 1, fieldName, arg, read, written);
+}
+
+static const argumentField_t argumentFields[] = {
+    [FIELD_FROM]                = { "From", parseNameField },
+    [FIELD_TO]                  = { "To", parseNameField },
+    [FIELD_QUANTITY]            = { "Quantity", parseAssetField },
+    [FIELD_MEMO]                = { "Memo", parseStringField },
+    [FIELD_RECEIVER]            = { "Receiver", parseNameField },
+    [FIELD_NET]                 = { "NET", parseAssetField },
+    [FIELD_CPU]                 = { "CPU", parseAssetField },
+    [FIELD_TRANSFER_STAKE]      = { "Transfer Stake", parseYesField },
+    [FIELD_ACCOUNT]             = { "Account", parseNameField },
+    [FIELD_BUYER]               = { "Buyer", parseNameField },
+    [FIELD_TOKENS]              = { "Tokens", parseAssetField },
+    [FIELD_BYTES]               = { "Bytes", parseUint32Field },
+    [FIELD_BYTES64]             = { "Bytes", parseUInt64Field },
+    [FIELD_PROXY]               = { "Proxy", parseNameField },
+    [FIELD_PRODUCER]            = { "Producer #%d [%d]", parseNameField },
+    [FIELD_PERMISSION]          = { "Permission", parseNameField },
+    [FIELD_PARENT]              = { "Parent", parseNameField },
+    [FIELD_PARENT_NULL]         = { "Parent", parseNullField },
+    [FIELD_THRESHOLD]           = { "Threshold", parseUint32Field },
+    [FIELD_KEY]                 = { "Key #%d", parseKeyField },
+    [FIELD_KEY_WEIGHT]          = { "Key #%d Weight", parseUint16Field },
+    [FIELD_AUTH_ACCOUNT]        = { "Account #%d", parsePermissionField },
+    [FIELD_AUTH_ACCOUNT_WEIGHT] = { "Account #%d Weight", parseUint16Field },
+    [FIELD_DELAY]               = { "Delay #%d", parseUint32Field },
+    [FIELD_DELAY_WEIGHT]        = { "Delay #%d Weight", parseUint16Field },
+    [FIELD_CONTRACT]            = { "Contract", parseNameField },
+    [FIELD_ACTION]              = { "Action", parseNameField },
+    [FIELD_CREATOR]             = { "Creator", parseNameField },
+    [FIELD_OWNER_KEY]           = { "Owner key", parsePublicKeyField },
+    [FIELD_ACTIVE_KEY]          = { "Active key", parsePublicKeyField },
+};
+
+void resetArgumentIndex(argumentIndex_t *index) {
+    index->count = 0;
+    index->dataLength = 0;
+    index->chunk = NULL;
+}
+
+void initActionDecoder(actionDecoder_t *decoder, argumentIndex_t *index) {
+    os_memset(decoder, 0, sizeof(actionDecoder_t));
+    decoder->index = index;
+    resetArgumentIndex(index);
+}
+
+/**
+ * Copy as much as available of size bytes into destination,
+ * decoder->pos keeps the number of bytes already gathered.
+*/
+static bool decoderGather(actionDecoder_t *decoder, uint8_t *destination, uint32_t size) {
+    uint32_t length = size - decoder->pos;
+    if (length > decoder->inLength) {
+        length = decoder->inLength;
+    }
+    os_memmove(destination + decoder->pos, decoder->in, length);
+    decoder->in += length;
+    decoder->inLength -= length;
+    decoder->pos += length;
+    if (decoder->pos < size) {
+        return false;
+    }
+    decoder->pos = 0;
+    return true;
+}
+
+decoderStatus_e decoderRead(actionDecoder_t *decoder, uint32_t size) {
+    if (size > sizeof(decoder->scratch)) {
+        PRINTF("decoderRead Scratch overflow\n");
+        return DECODER_ERROR;
+    }
+    return decoderGather(decoder, decoder->scratch, size) ? DECODER_DONE : DECODER_MORE;
+}
+
+decoderStatus_e decoderVarint(actionDecoder_t *decoder) {
+    while (decoder->inLength != 0) {
+        uint8_t byte = *decoder->in;
+        decoder->in++;
+        decoder->inLength--;
+        if (decoder->pos == 0) {
+            decoder->value = 0;
+        }
+        if (decoder->pos == 5) {
+            PRINTF("decoderVarint Overflow\n");
+            return DECODER_ERROR;
+        }
+        decoder->value |= (uint32_t)(byte & 0x7F) << (7 * decoder->pos);
+        decoder->pos++;
+        if ((byte & 0x80) == 0) {
+            decoder->pos = 0;
+            return DECODER_DONE;
+        }
+    }
+    return DECODER_MORE;
+}
+
+decoderStatus_e decoderLength(actionDecoder_t *decoder, uint32_t max) {
+    decoderStatus_e status = decoderVarint(decoder);
+    if (status == DECODER_DONE && decoder->value > max) {
+        PRINTF("decoderLength Length too large\n");
+        return DECODER_ERROR;
+    }
+    return status;
+}
+
+/**
+ * Reserve room for the next argument. A full page is handed over
+ * for review; an argument that does not fit an empty page is an error.
+*/
+static decoderStatus_e decoderReserve(actionDecoder_t *decoder, uint32_t size) {
+    argumentIndex_t *index = decoder->index;
+    if (index->count < ARGUMENT_INDEX_SIZE && index->dataLength + size <= sizeof(index->data)) {
+        return DECODER_DONE;
+    }
+    if (index->count == 0) {
+        PRINTF("decoderReserve Argument too large\n");
+        return DECODER_ERROR;
+    }
+    return DECODER_PAGE;
+}
+
+static void decoderCommit(actionDecoder_t *decoder, uint32_t offset, uint32_t size, uint8_t flags,
+                          argumentField_e field, uint32_t ordinal, uint32_t total) {
+    argumentIndex_t *index = decoder->index;
+    argumentIndexEntry_t *entry = &index->entries[index->count++];
+    entry->offset = offset;
+    entry->size = size;
+    entry->flags = flags;
+    entry->field = field;
+    entry->ordinal = ordinal;
+    entry->total = total;
+    if ((flags & ARGUMENT_IN_CHUNK) == 0) {
+        index->dataLength += size;
+    }
+}
+
+/**
+ * Value is whole in the current chunk: reference it instead of copying.
+*/
+static bool decoderReference(actionDecoder_t *decoder, uint32_t size, uint8_t flags,
+                             argumentField_e field, uint32_t ordinal, uint32_t total) {
+    argumentIndex_t *index = decoder->index;
+    if (index->chunk == NULL) {
+        index->chunk = decoder->in;
+    }
+    uint32_t offset = decoder->in - index->chunk;
+    if ((argumentOffset_t)offset != offset) {
+        return false;
+    }
+    decoderCommit(decoder, offset, size, ARGUMENT_IN_CHUNK | flags, field, ordinal, total);
+    decoder->in += size;
+    decoder->inLength -= size;
+    return true;
+}
+
+/**
+ * Chunk is exhausted and the next one will replace it: copy referenced
+ * values into argument data. If they do not fit, the page has to be
+ * reviewed while the chunk is still there.
+*/
+decoderStatus_e decoderReleaseChunk(actionDecoder_t *decoder) {
+    argumentIndex_t *index = decoder->index;
+    uint32_t required = 0;
+    uint8_t i;
+
+    if (index->chunk == NULL) {
+        return DECODER_DONE;
+    }
+    for (i = 0; i < index->count; ++i) {
+        if (index->entries[i].flags & ARGUMENT_IN_CHUNK) {
+            required += index->entries[i].size;
+        }
+    }
+    if (index->dataLength + required > sizeof(index->data)) {
+        return DECODER_PAGE;
+    }
+    for (i = 0; i < index->count; ++i) {
+        argumentIndexEntry_t *entry = &index->entries[i];
+        if (entry->flags & ARGUMENT_IN_CHUNK) {
+            os_memmove(index->data + index->dataLength, index->chunk + entry->offset, entry->size);
+            entry->offset = index->dataLength;
+            entry->flags &= ~ARGUMENT_IN_CHUNK;
+            index->dataLength += entry->size;
+        }
+    }
+    index->chunk = NULL;
+    return DECODER_DONE;
+}
+
+/**
+ * Value is gathered into argument data. If it continues in the next chunk,
+ * referenced values are copied first, so that the partial value is not
+ * overwritten when the chunk is released.
+*/
+static decoderStatus_e decoderStage(actionDecoder_t *decoder, uint32_t size) {
+    if (decoder->inLength < size) {
+        decoderStatus_e status = decoderReleaseChunk(decoder);
+        if (status != DECODER_DONE) {
+            return status;
+        }
+    }
+    return decoderReserve(decoder, size);
+}
+
+static decoderStatus_e decoderValue(actionDecoder_t *decoder, uint32_t size, uint8_t flags,
+                                   argumentField_e field, uint32_t ordinal, uint32_t total) {
+    argumentIndex_t *index = decoder->index;
+    if (decoder->pos == 0 && decoder->inLength >= size) {
+        if (index->count == ARGUMENT_INDEX_SIZE) {
+            return DECODER_PAGE;
+        }
+        if (decoderReference(decoder, size, flags, field, ordinal, total)) {
+            return DECODER_DONE;
+        }
+    }
+    if (decoder->pos == 0) {
+        decoderStatus_e status = decoderStage(decoder, size);
+        if (status != DECODER_DONE) {
+            return status;
+        }
+    }
+    if (!decoderGather(decoder, index->data + index->dataLength, size)) {
+        return DECODER_MORE;
+    }
+    decoderCommit(decoder, index->dataLength, size, flags, field, ordinal, total);
+    return DECODER_DONE;
+}
+
+decoderStatus_e decoderArgument(actionDecoder_t *decoder, uint32_t size, argumentField_e field, uint32_t ordinal, uint32_t total) {
+    return decoderValue(decoder, size, 0, field, ordinal, total);
+}
+
+/**
+ * Strings of value bytes are stored as raw text in windows of at most one
+ * screen, split evenly, each an argument referenced in the chunk or
+ * gathered like any other value, so a string never needs more room than a
+ * screen. The length is checked when it is read, stringLeft counts down
+ * as windows are stored.
+*/
+decoderStatus_e decoderString(actionDecoder_t *decoder, argumentField_e field, uint32_t ordinal, uint32_t total) {
+    uint32_t length = decoder->stringLength;
+    uint32_t left = decoder->stringLeft;
+    uint32_t parts = length == 0 ? 1 : (length + STRING_WINDOW_SIZE - 1) / STRING_WINDOW_SIZE;
+    uint32_t windowSize = (length + parts - 1) / parts;
+    for (;;) {
+        uint32_t window = left < windowSize ? left : windowSize;
+        uint32_t part = windowSize == 0 ? 1 : (length - left) / windowSize + 1;
+        uint8_t flags = ARGUMENT_TEXT | ARGUMENT_WINDOW(part, parts);
+        decoderStatus_e status = decoderValue(decoder, window, flags, field, ordinal, total);
+        if (status != DECODER_DONE) {
+            return status;
+        }
+        left -= window;
+        decoder->stringLeft = left;
+        if (left == 0) {
+            return DECODER_DONE;
+        }
+    }
+}
+
+decoderStatus_e decoderEmit(actionDecoder_t *decoder, uint32_t size, argumentField_e field, uint32_t ordinal, uint32_t total) {
+    argumentIndex_t *index = decoder->index;
+    decoderStatus_e status = decoderReserve(decoder, size);
+    if (status != DECODER_DONE) {
+        return status;
+    }
+    os_memmove(index->data + index->dataLength, decoder->scratch, size);
+    decoderCommit(decoder, index->dataLength, size, 0, field, ordinal, total);
+    return DECODER_DONE;
+}
+
+/**
+ * Public keys go through the key cache, a key repeated in the transaction
+ * (owner and active of a new account) is encoded once.
+*/
+static bool parseValue(fieldParser_t parser, publicKeyCache_t *keys, uint8_t *value, uint32_t valueLength,
+                       const char *label, actionArgument_t *arg) {
+    uint32_t read = 0;
+    uint32_t written = 0;
+
+    if (parser == (fieldParser_t)PIC(parseKeyField)) {
+        return parseCachedPublicKeyField(keys, value + 1, valueLength - 1, label, arg, &read, &written);
+    }
+    if (parser == (fieldParser_t)PIC(parsePublicKeyField)) {
+        return parseCachedPublicKeyField(keys, value, valueLength, label, arg, &read, &written);
+    }
+    return parser(value, valueLength, label, arg, &read, &written);
+}
+
+/**
+ * Render argument straight from its stored value.
+*/
+const uint8_t *indexedArgumentValue(const argumentIndex_t *index, uint8_t argNum) {
+    const argumentIndexEntry_t *entry = &index->entries[argNum];
+    return ((entry->flags & ARGUMENT_IN_CHUNK) ? index->chunk : index->data) + entry->offset;
+}
+
+bool parseIndexedArgument(const argumentIndex_t *index, const abiDescriptor_t *descriptor, publicKeyCache_t *keys,
+                          uint8_t argNum, actionArgument_t *arg) {
+    if (argNum >= index->count) {
+        PRINTF("parseIndexedArgument Invalid argument\n");
+        return false;
+    }
+
+    const argumentIndexEntry_t *entry = &index->entries[argNum];
+    uint8_t *value = (uint8_t *)indexedArgumentValue(index, argNum);
+    uint32_t valueLength = entry->size;
+    char numberedLabel[32] = { 0 };
+    fieldParser_t parser;
+    const char *label;
+
+    if (entry->field >= FIELD_DESCRIPTOR) {
+        // Host supplied labels are not formats
+        const abiDescriptorField_t *field = &descriptor->fields[entry->field - FIELD_DESCRIPTOR];
+        parser = abiTypeParser(field->type);
+        label = field->label;
+        if (entry->ordinal != 0) {
+            uint32_t labelLength = strlen(field->label);
+            os_memmove(numberedLabel, field->label, labelLength);
+            format_label(numberedLabel + labelLength, sizeof(numberedLabel) - labelLength, " #%d", entry->ordinal, 0);
+            label = numberedLabel;
+        }
+    } else {
+        const argumentField_t *field = entry->field < FIELD_ABI ? 
+            (const argumentField_t *)PIC(&argumentFields[entry->field]) : abiField(entry->field - FIELD_ABI);
+        parser = (fieldParser_t)PIC(field->parser);
+        label = (const char *)PIC(field->label);
+        if (entry->ordinal != 0) {
+            format_label(numberedLabel, sizeof(numberedLabel), label, entry->ordinal, entry->total);
+            label = numberedLabel;
+        }
+    }
+
+    if (entry->flags & ARGUMENT_TEXT) {
+        // String window, numbered when the string takes several
+        parser = (fieldParser_t)PIC(parseTextField);
+        if (ARGUMENT_PARTS(entry->flags) > 1) {
+            uint32_t labelLength = strlen(label);
+            if (labelLength > sizeof(numberedLabel) - 1) {
+                labelLength = sizeof(numberedLabel) - 1;
+            }
+            os_memmove(numberedLabel, label, labelLength);
+            format_label(numberedLabel + labelLength, sizeof(numberedLabel) - labelLength, " (%d/%d)",
+                         ARGUMENT_PART(entry->flags), ARGUMENT_PARTS(entry->flags));
+            label = numberedLabel;
+        }
+    }
+    return parseValue(parser, keys, value, valueLength, label, arg);
+}
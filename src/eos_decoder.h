@@ -0,0 +1,171 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __EOS_DECODER_H__
+#define __EOS_DECODER_H__
+
+#include <stdint.h>
+#include "eos_parse.h"
+
+/**
+ * Resumable action data decoders.
+ * Action data arrives in chunks, so every decoder is a stackless coroutine
+ * (protothread style): it keeps its resume point and loop counters in
+ * actionDecoder_t and returns DECODER_MORE whenever the chunk is exhausted.
+ * Displayable arguments are recorded in argumentIndex_t as they complete, so
+ * action data itself is never buffered: values received whole are referenced
+ * in the chunk, only values straddling chunks are copied. When the argument
+ * store is full the decoder returns DECODER_PAGE and resumes once the page
+ * has been reviewed. Malformed data yields DECODER_ERROR, which is passed
+ * up unchanged like any other status other than DECODER_DONE.
+ *
+ * Decoder locals do not survive a yield, use decoder fields instead.
+*/
+
+typedef enum decoderStatus_e {
+    DECODER_MORE,
+    DECODER_PAGE,
+    DECODER_DONE,
+    DECODER_ERROR
+} decoderStatus_e;
+
+typedef enum argumentField_e {
+    FIELD_FROM,
+    FIELD_TO,
+    FIELD_QUANTITY,
+    FIELD_MEMO,
+    FIELD_RECEIVER,
+    FIELD_NET,
+    FIELD_CPU,
+    FIELD_TRANSFER_STAKE,
+    FIELD_ACCOUNT,
+    FIELD_BUYER,
+    FIELD_TOKENS,
+    FIELD_BYTES,
+    FIELD_BYTES64,
+    FIELD_PROXY,
+    FIELD_PRODUCER,
+    FIELD_PERMISSION,
+    FIELD_PARENT,
+    FIELD_PARENT_NULL,
+    FIELD_THRESHOLD,
+    FIELD_KEY,
+    FIELD_KEY_WEIGHT,
+    FIELD_AUTH_ACCOUNT,
+    FIELD_AUTH_ACCOUNT_WEIGHT,
+    FIELD_DELAY,
+    FIELD_DELAY_WEIGHT,
+    FIELD_CONTRACT,
+    FIELD_ACTION,
+    FIELD_CREATOR,
+    FIELD_OWNER_KEY,
+    FIELD_ACTIVE_KEY,
+    // Fields of ABI described actions follow, see eos_abi.h
+    FIELD_ABI
+} argumentField_e;
+
+typedef bool (*fieldParser_t)(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+
+/**
+ * Labels of numbered fields are formats receiving entry ordinal and total.
+*/
+typedef struct argumentField_t {
+    const char *label;
+    fieldParser_t parser;
+} argumentField_t;
+
+typedef struct actionDecoder_t {
+    uint16_t resume;
+    uint16_t pos;
+    // ABI bytecode decoder: current instruction
+    const uint8_t *program;
+    uint32_t value;
+    // Vector registers, vectors hold at most ARGUMENT_ORDINAL_MAX entries
+    uint16_t count;
+    uint16_t total;
+    // String being stored: its length and the bytes left
+    uint16_t stringLength;
+    uint16_t stringLeft;
+    uint8_t scratch[8];
+    uint8_t *in;
+    uint32_t inLength;
+    argumentIndex_t *index;
+} actionDecoder_t;
+
+typedef decoderStatus_e (*actionDecoder_f)(actionDecoder_t *decoder);
+
+#define DECODER_BEGIN(d) switch ((d)->resume) { case 0:
+#define DECODER_END(d) } (d)->resume = 0; return DECODER_DONE
+
+#define DECODER_AWAIT(d, call)                                                 \
+    do {                                                                       \
+        (d)->resume = __LINE__;                                                \
+        case __LINE__: {                                                       \
+            decoderStatus_e __status = (call);                                 \
+            if (__status != DECODER_DONE) {                                    \
+                return __status;                                               \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+// Gather size bytes (up to 8) into scratch
+#define DECODE_READ(d, size) DECODER_AWAIT(d, decoderRead(d, size))
+// Read variable length unsigned integer into value
+#define DECODE_VARINT(d) DECODER_AWAIT(d, decoderVarint(d))
+// Read a varint length into value, a length above max is an error
+#define DECODE_LENGTH(d, max) DECODER_AWAIT(d, decoderLength(d, max))
+// Store next size bytes as an argument
+#define DECODE_ARGUMENT(d, size, field, ordinal, total) \
+    DECODER_AWAIT(d, decoderArgument(d, size, field, ordinal, total))
+// Store a string of value bytes, a length read with DECODE_LENGTH up to
+// STRING_MAX_LENGTH, as arguments
+#define DECODE_STRING(d, field, ordinal, total)                                \
+    do {                                                                       \
+        (d)->stringLength = (d)->value;                                        \
+        (d)->stringLeft = (d)->value;                                          \
+        DECODER_AWAIT(d, decoderString(d, field, ordinal, total));             \
+    } while (0)
+// Store first size bytes of scratch as an argument
+#define DECODE_EMIT(d, size, field, ordinal, total) \
+    DECODER_AWAIT(d, decoderEmit(d, size, field, ordinal, total))
+
+void initActionDecoder(actionDecoder_t *decoder, argumentIndex_t *index);
+void resetArgumentIndex(argumentIndex_t *index);
+
+decoderStatus_e decoderRead(actionDecoder_t *decoder, uint32_t size);
+decoderStatus_e decoderVarint(actionDecoder_t *decoder);
+decoderStatus_e decoderLength(actionDecoder_t *decoder, uint32_t max);
+decoderStatus_e decoderArgument(actionDecoder_t *decoder, uint32_t size, argumentField_e field, uint32_t ordinal, uint32_t total);
+decoderStatus_e decoderString(actionDecoder_t *decoder, argumentField_e field, uint32_t ordinal, uint32_t total);
+decoderStatus_e decoderEmit(actionDecoder_t *decoder, uint32_t size, argumentField_e field, uint32_t ordinal, uint32_t total);
+decoderStatus_e decoderReleaseChunk(actionDecoder_t *decoder);
+
+/**
+ * Bytes of argument argNum, valid as long as the chunk it may refer to.
+*/
+const uint8_t *indexedArgumentValue(const argumentIndex_t *index, uint8_t argNum);
+
+struct abiDescriptor_t;
+
+/**
+ * Descriptor is the one of the decoded action, NULL unless uploaded.
+ * Public keys are encoded through keys, which may be NULL.
+*/
+bool parseIndexedArgument(const argumentIndex_t *index, const struct abiDescriptor_t *descriptor, publicKeyCache_t *keys,
+                          uint8_t argNum, actionArgument_t *arg);
+
+#endif // __EOS_DECODER_H__
@@ -34,58 +34,71 @@ void printString(const char in[], const char fieldName[], actionArgument_t *arg)
     os_memmove(arg->data, in, inLength);
 }
 
-void parseNameField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+bool parseNameField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
     if (inLength < sizeof(name_t)) {
         PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+        return false;
     }
     uint32_t labelLength = strlen(fieldName);
     if (labelLength > sizeof(arg->label)) {
         PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+        return false;
     }
 
     os_memset(arg->label, 0, sizeof(arg->label));
     os_memset(arg->data, 0, sizeof(arg->data));
     
     os_memmove(arg->label, fieldName, labelLength);
-    name_t name = buffer_to_name_type(in, sizeof(name_t));
-    uint32_t writtenToBuff = name_to_string(name, arg->data, sizeof(arg->data)-1);
+    name_t name;
+    uint32_t writtenToBuff;
+    if (!buffer_to_name_type(in, sizeof(name_t), &name) ||
+        !name_to_string(name, arg->data, sizeof(arg->data)-1, &writtenToBuff)) {
+        return false;
+    }
 
     *read = sizeof(name_t);
     *written = writtenToBuff;
+    return true;
+}
+
+bool parsePublicKeyField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+    return parseCachedPublicKeyField(NULL, in, inLength, fieldName, arg, read, written);
 }
 
-void parsePublicKeyField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+bool parseCachedPublicKeyField(publicKeyCache_t *keys, uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
     if (inLength < 33) {
         PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+        return false;
     }
     uint32_t labelLength = strlen(fieldName);
     if (labelLength > sizeof(arg->label)) {
         PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+        return false;
     }
 
     os_memset(arg->label, 0, sizeof(arg->label));
     os_memset(arg->data, 0, sizeof(arg->data));
 
     os_memmove(arg->label, fieldName, labelLength);
-    uint32_t writtenToBuff = compressed_public_key_to_wif(in, 33, arg->data, sizeof(arg->data)-1);
+    uint32_t writtenToBuff;
+    if (!cached_public_key_to_wif(keys, in, 33, arg->data, sizeof(arg->data)-1, &writtenToBuff)) {
+        return false;
+    }
 
     *read = 33;
     *written = writtenToBuff;
+    return true;
 }
 
-void parseUint16Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+bool parseUint16Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
     if (inLength < sizeof(uint16_t)) {
         PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+        return false;
     }
     uint32_t labelLength = strlen(fieldName);
     if (labelLength > sizeof(arg->label)) {
         PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+        return false;
     }
     
     os_memset(arg->label, 0, sizeof(arg->label));
@@ -94,21 +107,21 @@ void parseUint16Field(uint8_t *in, uint32_t inLength, const char fieldName[], ac
     os_memmove(arg->label, fieldName, labelLength);
     uint16_t value;
     os_memmove(&value, in, sizeof(uint16_t));
-    snprintf(arg->data, sizeof(arg->data)-1, "%d", value);
     
     *read = sizeof(uint16_t);
-    *written = strlen(arg->data);
+    *written = format_decimal(value, 1, arg->data);
+    return true;
 }
 
-void parseUint32Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+bool parseUint32Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
     if (inLength < sizeof(uint32_t)) {
         PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+        return false;
     }
     uint32_t labelLength = strlen(fieldName);
     if (labelLength > sizeof(arg->label)) {
         PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+        return false;
     }
     
     os_memset(arg->label, 0, sizeof(arg->label));
@@ -117,21 +130,21 @@ void parseUint32Field(uint8_t *in, uint32_t inLength, const char fieldName[], ac
     os_memmove(arg->label, fieldName, labelLength);
     uint32_t value;
     os_memmove(&value, in, sizeof(uint32_t));
-    snprintf(arg->data, sizeof(arg->data)-1, "%d", value);
     
     *read = sizeof(uint32_t);
-    *written = strlen(arg->data);
+    *written = format_decimal(value, 1, arg->data);
+    return true;
 }
 
-void parseUInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+bool parseUInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
     if (inLength < sizeof(uint64_t)) {
         PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+        return false;
     }
     uint32_t labelLength = strlen(fieldName);
     if (labelLength > sizeof(arg->label)) {
         PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+        return false;
     }
     
     os_memset(arg->label, 0, sizeof(arg->label));
@@ -140,22 +153,22 @@ void parseUInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], ac
     os_memmove(arg->label, fieldName, labelLength);
     uint64_t value;
     os_memmove(&value, in, sizeof(uint64_t));
-    ui64toa(value, arg->data);
     
     *read = sizeof(uint64_t);
-    *written = strlen(arg->data);
+    *written = format_decimal(value, 1, arg->data);
+    return true;
 }
 
-void parseAssetField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+bool parseAssetField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
     if (inLength < sizeof(asset_t)) {
         PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+        return false;
     }
 
     uint32_t labelLength = strlen(fieldName);
     if (labelLength > sizeof(arg->label)) {
         PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+        return false;
     }
 
     os_memset(arg->label, 0, sizeof(arg->label));
@@ -164,17 +177,43 @@ void parseAssetField(uint8_t *in, uint32_t inLength, const char fieldName[], act
     os_memmove(arg->label, fieldName, labelLength);
     asset_t asset;
     os_memmove(&asset, in, sizeof(asset));
-    uint32_t writtenToBuff = asset_to_string(&asset, arg->data, sizeof(arg->data)-1); 
+    uint32_t writtenToBuff;
+    if (!asset_to_string(&asset, arg->data, sizeof(arg->data)-1, &writtenToBuff)) {
+        return false;
+    }
 
     *read = sizeof(asset_t);
     *written = writtenToBuff;
+    return true;
 }
 
-void parseStringField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+bool parseTextField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
     uint32_t labelLength = strlen(fieldName);
     if (labelLength > sizeof(arg->label)) {
         PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+        return false;
+    }
+    if (inLength > sizeof(arg->data) - 1) {
+        PRINTF("parseActionData Text too long\n");
+        return false;
+    }
+
+    os_memset(arg->label, 0, sizeof(arg->label));
+    os_memset(arg->data, 0, sizeof(arg->data));
+
+    os_memmove(arg->label, fieldName, labelLength);
+    os_memmove(arg->data, in, inLength);
+
+    *read = inLength;
+    *written = inLength;
+    return true;
+}
+
+bool parseStringField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+    uint32_t labelLength = strlen(fieldName);
+    if (labelLength > sizeof(arg->label)) {
+        PRINTF("parseActionData Label too long\n");
+        return false;
     }
 
     os_memset(arg->label, 0, sizeof(arg->label));
@@ -186,12 +225,12 @@ void parseStringField(uint8_t *in, uint32_t inLength, const char fieldName[], ac
     uint32_t readFromBuffer = unpack_variant32(in, inLength, &fieldLength);
     if (fieldLength > sizeof(arg->data) - 1) {
         PRINTF("parseActionData Insufficient bufferg\n");
-        THROW(EXCEPTION);
+        return false;
     } 
 
     if (inLength < fieldLength) {
         PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+        return false;
     }
 
     in += readFromBuffer;
@@ -204,21 +243,30 @@ void parseStringField(uint8_t *in, uint32_t inLength, const char fieldName[], ac
 
     *read = readFromBuffer + fieldLength;
     *written = fieldLength;
+    return true;
 }
 
-void parsePermissionField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
+bool parsePermissionField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
     uint32_t accountWrittenLength = 0;
     
-    parseNameField(in, inLength, fieldName, arg, read, &accountWrittenLength);
+    if (!parseNameField(in, inLength, fieldName, arg, read, &accountWrittenLength)) {
+        return false;
+    }
     strcat(arg->data, "@");
     
     in += *read; inLength -= *read;
     if (inLength < sizeof(name_t)) {
         PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+        return false;
+    }
+    name_t name;
+    uint32_t permissionWrittenLength;
+    if (!buffer_to_name_type(in, sizeof(name_t), &name) ||
+        !name_to_string(name, arg->data + accountWrittenLength + 1, sizeof(arg->data) - accountWrittenLength - 1, &permissionWrittenLength)) {
+        return false;
     }
-    name_t name = buffer_to_name_type(in, sizeof(name_t));
     
-    *written = name_to_string(name, arg->data + accountWrittenLength + 1, sizeof(arg->data) - accountWrittenLength - 1) + accountWrittenLength;
+    *written = permissionWrittenLength + accountWrittenLength;
     *read += sizeof(name_t);
+    return true;
 }
@@ -19,20 +19,78 @@
 #define __EOS_PARSE_H__
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "eos_profile.h"
+#include "eos_types.h"
 
 typedef struct actionArgument_t {
     char label[32];
     char data[128];
 } actionArgument_t;
 
+#define ARGUMENT_IN_CHUNK 0x01
+// Raw text, window part out of parts (1 to 3) of a string
+#define ARGUMENT_TEXT 0x02
+// Strings are shown in windows of one screen, up to the chain memo limit
+#define STRING_WINDOW_SIZE (sizeof(((actionArgument_t *)0)->data) - 1)
+#define STRING_MAX_LENGTH 256
+#define ARGUMENT_WINDOW(part, parts) (((part) << 4) | ((parts) << 6))
+#define ARGUMENT_PART(flags) (((flags) >> 4) & 0x03)
+#define ARGUMENT_PARTS(flags) (((flags) >> 6) & 0x03)
+
+/**
+ * Location of a single displayable argument.
+ * Values received whole within the current chunk are referenced in place
+ * (ARGUMENT_IN_CHUNK, offset from chunk), others are copied into argument
+ * data. Field selects label and parser, ordinal numbers repeated fields
+ * starting from 1 (0 for fields that appear once) out of total, vectors
+ * of more than ARGUMENT_ORDINAL_MAX entries are rejected by the decoders.
+*/
+#define ARGUMENT_ORDINAL_MAX UINT8_MAX
+
+typedef struct argumentIndexEntry_t {
+    argumentOffset_t offset;
+    uint8_t size;
+    uint8_t flags;
+    uint8_t field;
+    uint8_t ordinal;
+    uint8_t total;
+} argumentIndexEntry_t;
+
+/**
+ * Arguments decoded from action data, one review page.
+ * Chunk is valid until the host sends next APDU, i.e. until the page is
+ * reviewed or the chunk is exhausted.
+*/
+typedef struct argumentIndex_t {
+    uint8_t count;
+    uint16_t dataLength;
+    uint8_t *chunk;
+    argumentIndexEntry_t entries[ARGUMENT_INDEX_SIZE];
+    uint8_t data[ARGUMENT_DATA_SIZE];
+} argumentIndex_t;
+
 void printString(const char in[], const char fieldName[], actionArgument_t *arg);
-void parseNameField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parsePublicKeyField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseUint16Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseUint32Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseUInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseAssetField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseStringField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parsePermissionField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+
+/**
+ * Field parsers render a value into arg and return false if the value
+ * is malformed or does not fit, leaving arg unspecified.
+*/
+bool parseNameField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+bool parsePublicKeyField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+/**
+ * parsePublicKeyField taking the encoding from keys when the key was shown before.
+*/
+bool parseCachedPublicKeyField(publicKeyCache_t *keys, uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+bool parseUint16Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+bool parseUint32Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+bool parseUInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+bool parseAssetField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+/**
+ * Renders inLength bytes of raw text, one window of a string.
+*/
+bool parseTextField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+bool parseStringField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+bool parsePermissionField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
 
 #endif
@@ -0,0 +1,229 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "eos_parse_abi.h"
+#include "os.h"
+#include <string.h>
+
+#include "eos_abi.h"
+
+#define PROGRAM(d, offset) ((d)->program[offset])
+// Fields inside a vector are numbered from 1
+#define ORDINAL(d) ((d)->total != 0 ? (d)->count + 1 : 0)
+
+typedef struct abiType_t {
+    // Size of the value, 0 if it is a string
+    uint8_t size;
+    fieldParser_t parser;
+} abiType_t;
+
+static const abiType_t abiTypes[ABI_TYPE_COUNT] = {
+    [ABI_TYPE_NAME]       = { sizeof(name_t), parseNameField },
+    [ABI_TYPE_ASSET]      = { sizeof(asset_t), parseAssetField },
+    [ABI_TYPE_STRING]     = { 0, parseStringField },
+    [ABI_TYPE_UINT16]     = { sizeof(uint16_t), parseUint16Field },
+    [ABI_TYPE_UINT32]     = { sizeof(uint32_t), parseUint32Field },
+    [ABI_TYPE_UINT64]     = { sizeof(uint64_t), parseUInt64Field },
+    [ABI_TYPE_PUBLIC_KEY] = { sizeof(public_key_t), parsePublicKeyField },
+    [ABI_TYPE_PERMISSION] = { sizeof(permisssion_level_t), parsePermissionField },
+};
+
+void initAbiDecoder(actionDecoder_t *decoder, uint16_t offset) {
+    decoder->program = (const uint8_t *)PIC(abiProgram) + offset;
+}
+
+const argumentField_t *abiField(uint8_t index) {
+    return (const argumentField_t *)PIC(&abiFields[index]);
+}
+
+fieldParser_t abiTypeParser(uint8_t type) {
+    const abiType_t *abiType = (const abiType_t *)PIC(&abiTypes[type]);
+    return (fieldParser_t)PIC(abiType->parser);
+}
+
+/**
+ * Field operand of a descriptor program has to match the value stored.
+*/
+static bool checkAbiField(const abiDescriptor_t *descriptor, uint8_t field, uint8_t size) {
+    if (field < FIELD_DESCRIPTOR || field - FIELD_DESCRIPTOR >= descriptor->fieldCount) {
+        return false;
+    }
+    const abiType_t *abiType = (const abiType_t *)PIC(&abiTypes[descriptor->fields[field - FIELD_DESCRIPTOR].type]);
+    return abiType->size == size;
+}
+
+static bool checkAbiProgram(const abiDescriptor_t *descriptor) {
+    const uint8_t *program = descriptor->program;
+    uint32_t pc = 0;
+    // Body of the open vector, vectors do not nest
+    bool inVector = false;
+    uint32_t bodyStart = 0;
+
+    while (pc < ABI_DESCRIPTOR_PROGRAM_SIZE) {
+        uint8_t op = program[pc];
+        uint32_t length = (op == ABI_OP_END) ? 1 : (op == ABI_OP_FIXED) ? 3 : 2;
+        if (pc + length > ABI_DESCRIPTOR_PROGRAM_SIZE) {
+            return false;
+        }
+        if (op == ABI_OP_END) {
+            return !inVector;
+        } else if (op == ABI_OP_FIXED) {
+            if (program[pc + 1] == 0 || !checkAbiField(descriptor, program[pc + 2], program[pc + 1])) {
+                return false;
+            }
+        } else if (op == ABI_OP_STRING) {
+            if (!checkAbiField(descriptor, program[pc + 1], 0)) {
+                return false;
+            }
+        } else if (op == ABI_OP_VARUINT32) {
+            if (!checkAbiField(descriptor, program[pc + 1], sizeof(uint32_t))) {
+                return false;
+            }
+        } else if (op == ABI_OP_SKIP) {
+            if (program[pc + 1] == 0 || program[pc + 1] > sizeof(((actionDecoder_t *)0)->scratch)) {
+                return false;
+            }
+        } else if (op == ABI_OP_VECTOR) {
+            // Every instruction of a body consumes data, so loops end
+            if (inVector || program[pc + 1] == 0) {
+                return false;
+            }
+            inVector = true;
+            bodyStart = pc + length;
+        } else if (op == ABI_OP_LOOP) {
+            if (!inVector || pc != bodyStart + program[pc + 1] || program[bodyStart - 1] != program[pc + 1]) {
+                return false;
+            }
+            inVector = false;
+        } else {
+            return false;
+        }
+        pc += length;
+    }
+    return false;
+}
+
+bool checkAbiDescriptor(const uint8_t *buffer, uint32_t length, abiDescriptor_t *descriptor) {
+    uint8_t i;
+    if (length != ABI_DESCRIPTOR_SIZE) {
+        PRINTF("checkAbiDescriptor Invalid length\n");
+        return false;
+    }
+    os_memmove(&descriptor->contract, buffer, sizeof(name_t));
+    buffer += sizeof(name_t);
+    os_memmove(&descriptor->action, buffer, sizeof(name_t));
+    buffer += sizeof(name_t);
+    descriptor->fieldCount = *buffer++;
+    if (descriptor->fieldCount > ABI_DESCRIPTOR_FIELDS) {
+        PRINTF("checkAbiDescriptor Too many fields\n");
+        return false;
+    }
+    for (i = 0; i < ABI_DESCRIPTOR_FIELDS; ++i) {
+        abiDescriptorField_t *field = &descriptor->fields[i];
+        field->type = *buffer++;
+        os_memmove(field->label, buffer, sizeof(field->label));
+        buffer += sizeof(field->label);
+        if (i >= descriptor->fieldCount) {
+            continue;
+        }
+        // Labels are printed as is, so they can not hold formats
+        if (field->type >= ABI_TYPE_COUNT || field->label[0] == '\0' ||
+            strnlen(field->label, sizeof(field->label)) == sizeof(field->label) ||
+            strchr(field->label, '%') != NULL) {
+            PRINTF("checkAbiDescriptor Invalid field\n");
+            return false;
+        }
+    }
+    os_memmove(descriptor->program, buffer, sizeof(descriptor->program));
+    if (!checkAbiProgram(descriptor)) {
+        PRINTF("checkAbiDescriptor Invalid program\n");
+        return false;
+    }
+    return true;
+}
+
+uint8_t findAbiDescriptor(const abiDescriptorStore_t *store, name_t contract, name_t action) {
+    uint8_t i;
+    if (store == NULL) {
+        return ABI_DESCRIPTOR_NONE;
+    }
+    for (i = 0; i < ABI_DESCRIPTOR_SLOTS; ++i) {
+        if (store->used[i] != 0 && store->slots[i].contract == contract && store->slots[i].action == action) {
+            return i;
+        }
+    }
+    return ABI_DESCRIPTOR_NONE;
+}
+
+uint8_t abiDescriptorSlot(const abiDescriptorStore_t *store, name_t contract, name_t action) {
+    uint8_t slot = findAbiDescriptor(store, contract, action);
+    uint8_t i;
+    if (slot != ABI_DESCRIPTOR_NONE) {
+        return slot;
+    }
+    slot = 0;
+    for (i = 1; i < ABI_DESCRIPTOR_SLOTS; ++i) {
+        if (store->used[i] < store->used[slot]) {
+            slot = i;
+        }
+    }
+    return slot;
+}
+
+decoderStatus_e decodeAbi(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    while (PROGRAM(d, 0) != ABI_OP_END) {
+        if (PROGRAM(d, 0) == ABI_OP_FIXED) {
+            DECODE_ARGUMENT(d, PROGRAM(d, 1), PROGRAM(d, 2), ORDINAL(d), d->total);
+            d->program += 3;
+        } else if (PROGRAM(d, 0) == ABI_OP_STRING) {
+            DECODE_LENGTH(d, STRING_MAX_LENGTH);
+            DECODE_STRING(d, PROGRAM(d, 1), ORDINAL(d), d->total);
+            d->program += 2;
+        } else if (PROGRAM(d, 0) == ABI_OP_VARUINT32) {
+            DECODE_VARINT(d);
+            d->scratch[0] = d->value;
+            d->scratch[1] = d->value >> 8;
+            d->scratch[2] = d->value >> 16;
+            d->scratch[3] = d->value >> 24;
+            DECODE_EMIT(d, sizeof(uint32_t), PROGRAM(d, 1), ORDINAL(d), d->total);
+            d->program += 2;
+        } else if (PROGRAM(d, 0) == ABI_OP_SKIP) {
+            DECODE_READ(d, PROGRAM(d, 1));
+            d->program += 2;
+        } else if (PROGRAM(d, 0) == ABI_OP_VECTOR) {
+            DECODE_LENGTH(d, ARGUMENT_ORDINAL_MAX);
+            d->total = d->value;
+            d->count = 0;
+            // Empty vector: skip the body and its loop instruction
+            d->program += (d->total == 0) ? 2 + PROGRAM(d, 1) + 2 : 2;
+        } else if (PROGRAM(d, 0) == ABI_OP_LOOP) {
+            d->count++;
+            if (d->count < d->total) {
+                d->program -= PROGRAM(d, 1);
+            } else {
+                d->count = 0;
+                d->total = 0;
+                d->program += 2;
+            }
+        } else {
+            PRINTF("decodeAbi Invalid instruction\n");
+            return DECODER_ERROR;
+        }
+    }
+    DECODER_END(d);
+}
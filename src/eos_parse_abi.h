@@ -0,0 +1,130 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __EOS_PARSE_ABI_H__
+#define __EOS_PARSE_ABI_H__
+
+#include "eos_decoder.h"
+#include "eos_types.h"
+
+/**
+ * Actions described by a contract ABI are decoded by one interpreter.
+ * gen_actions.py compiles the action struct into bytecode embedded in
+ * eos_abi.h, the registry entry points at its first instruction. Other
+ * actions run the same bytecode from a descriptor uploaded by the host. Structs
+ * are flattened by the compiler and vectors do not nest, so the vector
+ * count and total are the only registers. Fields inside a vector are
+ * numbered. Instructions and their operand bytes:
+ *
+ * ABI_OP_FIXED size field   value of a fixed size, up to 255
+ * ABI_OP_STRING field       varuint32 length followed by the bytes
+ * ABI_OP_VARUINT32 field    rendered as uint32
+ * ABI_OP_SKIP size          bytes not displayed, up to 8
+ * ABI_OP_VECTOR length      varuint32 count up to 255, the body is the next
+ *                           length bytes
+ * ABI_OP_LOOP length        end of the body of length bytes
+ * ABI_OP_END
+*/
+#define ABI_OP_END 0x00
+#define ABI_OP_FIXED 0x01
+#define ABI_OP_STRING 0x02
+#define ABI_OP_VARUINT32 0x03
+#define ABI_OP_SKIP 0x04
+#define ABI_OP_VECTOR 0x05
+#define ABI_OP_LOOP 0x06
+
+/**
+ * Host supplied descriptor of one action, kept in NVM by the application.
+ * Field operands of its program are FIELD_DESCRIPTOR + index into fields,
+ * labels are zero terminated and numbered by the device inside vectors.
+ * Wire format is the struct itself, fields in order without padding.
+*/
+#define ABI_DESCRIPTOR_FIELDS 8
+#define ABI_DESCRIPTOR_LABEL_SIZE 20
+#define ABI_DESCRIPTOR_PROGRAM_SIZE 64
+#define ABI_DESCRIPTOR_SIZE (2 * sizeof(name_t) + 1 + \
+    ABI_DESCRIPTOR_FIELDS * (1 + ABI_DESCRIPTOR_LABEL_SIZE) + ABI_DESCRIPTOR_PROGRAM_SIZE)
+
+#define FIELD_DESCRIPTOR 0xF0
+
+/**
+ * Rendering of a descriptor field, FIXED operands must match the size.
+*/
+typedef enum abiFieldType_e {
+    ABI_TYPE_NAME,
+    ABI_TYPE_ASSET,
+    ABI_TYPE_STRING,
+    ABI_TYPE_UINT16,
+    ABI_TYPE_UINT32,
+    ABI_TYPE_UINT64,
+    ABI_TYPE_PUBLIC_KEY,
+    ABI_TYPE_PERMISSION,
+    ABI_TYPE_COUNT
+} abiFieldType_e;
+
+typedef struct abiDescriptorField_t {
+    uint8_t type;
+    char label[ABI_DESCRIPTOR_LABEL_SIZE];
+} abiDescriptorField_t;
+
+typedef struct abiDescriptor_t {
+    name_t contract;
+    name_t action;
+    uint8_t fieldCount;
+    abiDescriptorField_t fields[ABI_DESCRIPTOR_FIELDS];
+    uint8_t program[ABI_DESCRIPTOR_PROGRAM_SIZE];
+} abiDescriptor_t;
+
+/**
+ * Least recently used cache of descriptors, keyed by (contract, action).
+ * Used holds the clock value of the last use of a slot, 0 if it is empty.
+*/
+#define ABI_DESCRIPTOR_SLOTS 4
+#define ABI_DESCRIPTOR_NONE 0xFF
+
+typedef struct abiDescriptorStore_t {
+    abiDescriptor_t slots[ABI_DESCRIPTOR_SLOTS];
+    uint32_t used[ABI_DESCRIPTOR_SLOTS];
+    uint32_t clock;
+} abiDescriptorStore_t;
+
+decoderStatus_e decodeAbi(actionDecoder_t *decoder);
+
+/**
+ * Point decoder at compiled bytecode, offset taken from the registry.
+*/
+void initAbiDecoder(actionDecoder_t *decoder, uint16_t offset);
+
+/**
+ * Label and parser of argument field FIELD_ABI + index.
+*/
+const argumentField_t *abiField(uint8_t index);
+fieldParser_t abiTypeParser(uint8_t type);
+
+/**
+ * Validates an uploaded descriptor and its program, the interpreter 
+ * trusts it once stored.
+*/
+bool checkAbiDescriptor(const uint8_t *buffer, uint32_t length, abiDescriptor_t *descriptor);
+uint8_t findAbiDescriptor(const abiDescriptorStore_t *store, name_t contract, name_t action);
+/**
+ * Slot a new descriptor goes to: the one with the same key, else an
+ * empty one, else the least recently used.
+*/
+uint8_t abiDescriptorSlot(const abiDescriptorStore_t *store, name_t contract, name_t action);
+
+#endif
@@ -19,368 +19,194 @@
 #include "eos_types.h"
 #include "os.h"
 
-void parseDelegate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "From", arg, &read, &written);
-    } else if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Receiver", arg, &read, &written);
-    } else if (argNum == 2) {
-        buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-        parseAssetField(buffer, bufferLength, "NET", arg, &read, &written);
-    } else if (argNum == 3) {
-        buffer += 2 * sizeof(name_t) + sizeof(asset_t); bufferLength -= 2 * sizeof(name_t) + sizeof(asset_t);
-        parseAssetField(buffer, bufferLength, "CPU", arg, &read, &written);
-    } else if (argNum == 4) {
-        printString("Yes", "Transfer Stake", arg);
-    }
+static name_t readName(uint8_t *buffer) {
+    name_t value = 0;
+    os_memmove(&value, buffer, sizeof(value));
+    return value;
 }
 
-void parseUndelegate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "From", arg, &read, &written);
-    } else if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Receiver", arg, &read, &written);
-    } else if (argNum == 2) {
-        buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-        parseAssetField(buffer, bufferLength, "NET", arg, &read, &written);
-    } else if (argNum == 3) {
-        buffer += 2 * sizeof(name_t) + sizeof(asset_t); bufferLength -= 2 * sizeof(name_t) + sizeof(asset_t);
-        parseAssetField(buffer, bufferLength, "CPU", arg, &read, &written);
-    }
+decoderStatus_e decodeDelegate(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_FROM, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_RECEIVER, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(asset_t), FIELD_NET, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(asset_t), FIELD_CPU, 0, 0);
+    DECODE_READ(d, 1);
+    if (d->scratch[0] != 0) {
+        DECODE_EMIT(d, 0, FIELD_TRANSFER_STAKE, 0, 0);
+    }
+    DECODER_END(d);
 }
 
-void parseRefund(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Account", arg, &read, &written);
-    }
+decoderStatus_e decodeUndelegate(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_FROM, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_RECEIVER, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(asset_t), FIELD_NET, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(asset_t), FIELD_CPU, 0, 0);
+    DECODER_END(d);
 }
 
-void parseBuyRam(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Buyer", arg, &read, &written);
-    } else if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Receiver", arg, &read, &written);
-    } else if (argNum == 2) {
-        buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-        parseAssetField(buffer, bufferLength, "Tokens", arg, &read, &written);
-    }
+decoderStatus_e decodeRefund(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACCOUNT, 0, 0);
+    DECODER_END(d);
 }
 
-void parseBuyRamBytes(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Buyer", arg, &read, &written);
-    } else if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Receiver", arg, &read, &written);
-    } else if (argNum == 2) {
-        buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-        parseUint32Field(buffer, bufferLength, "Bytes", arg, &read, &written);
-    }
+decoderStatus_e decodeBuyRam(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_BUYER, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_RECEIVER, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(asset_t), FIELD_TOKENS, 0, 0);
+    DECODER_END(d);
 }
 
-void parseSellRam(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Receiver", arg, &read, &written);
-    } else if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseUInt64Field(buffer, bufferLength, "Bytes", arg, &read, &written);
-    }
+decoderStatus_e decodeBuyRamBytes(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_BUYER, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_RECEIVER, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(uint32_t), FIELD_BYTES, 0, 0);
+    DECODER_END(d);
 }
 
-void parseVoteProducer(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Account", arg, &read, &written);
-        return;
-    }
-
-    uint8_t *proxyBuffer = buffer + sizeof(name_t);
-    name_t proxy = 0;
-    os_memmove(&proxy, proxyBuffer, sizeof(name_t));
-    if (proxy != 0 && argNum == 1) {
-        parseNameField(proxyBuffer, sizeof(name_t), "Proxy", arg, &read, &written);
-        return;
-    }
-
-    // Move to producers list
-    buffer += 2 * sizeof(name_t);
-    bufferLength -= 2 * sizeof(name_t);
-
-    uint32_t totalProducers = 0;
-    read = unpack_variant32(buffer, bufferLength, &totalProducers);
-    buffer += read; bufferLength -= read;
-
-    uint32_t producerIndex = argNum - 1;
-    buffer += producerIndex * sizeof(name_t);
-    bufferLength -= producerIndex * sizeof(name_t);
-
-    char label[14] = { 0 };
-    snprintf(label, sizeof(label) - 1, "Producer #%d [%d]", argNum, totalProducers);
-    parseNameField(buffer, bufferLength, label, arg, &read, &written);
+decoderStatus_e decodeSellRam(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_RECEIVER, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(uint64_t), FIELD_BYTES64, 0, 0);
+    DECODER_END(d);
 }
 
-void parseUpdateAuth(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Account", arg, &read, &written);
-        return;
-    } 
-    
-    if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Permission", arg, &read, &written);
-        return;
-    }
-    
-    uint8_t *parentBuffer = buffer + 2 * sizeof(name_t);
-    name_t parent = 0;
-    os_memmove(&parent, parentBuffer, sizeof(name_t));
-    if (parent != 0 && argNum == 2) {
-        parseNameField(parentBuffer, sizeof(name_t), "Parent", arg, &read, &written);
-        return;
-    } else if (argNum == 2) {
-        uint8_t null[] = {4, 'N', 'U', 'L', 'L'};
-        parseStringField(null, sizeof(null), "Parent", arg, &read, &written);
-        return;
+/**
+ * Voting through a proxy and for producers are mutually exclusive,
+ * the system contract rejects both at once.
+*/
+decoderStatus_e decodeVoteProducer(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACCOUNT, 0, 0);
+    DECODE_READ(d, sizeof(name_t));
+    if (readName(d->scratch) != 0) {
+        DECODE_EMIT(d, sizeof(name_t), FIELD_PROXY, 0, 0);
+        DECODE_VARINT(d);
+        if (d->value != 0) {
+            PRINTF("decodeVoteProducer Proxy and producers\n");
+            return DECODER_ERROR;
+        }
+    } else {
+        DECODE_LENGTH(d, ARGUMENT_ORDINAL_MAX);
+        for (d->total = d->value, d->count = 0; d->count < d->total; d->count++) {
+            DECODE_ARGUMENT(d, sizeof(name_t), FIELD_PRODUCER, d->count + 1, d->total);
+        }
     }
+    DECODER_END(d);
+}
 
-    if (argNum == 3) {
-        buffer += 3 * sizeof(name_t); bufferLength -= 3 * sizeof(name_t); 
-        parseUint32Field(buffer, bufferLength, "Threshold", arg, &read, &written);
-        return;
+decoderStatus_e decodeUpdateAuth(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACCOUNT, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_PERMISSION, 0, 0);
+    DECODE_READ(d, sizeof(name_t));
+    if (readName(d->scratch) != 0) {
+        DECODE_EMIT(d, sizeof(name_t), FIELD_PARENT, 0, 0);
+    } else {
+        DECODE_EMIT(d, 0, FIELD_PARENT_NULL, 0, 0);
     }
+    DECODE_ARGUMENT(d, sizeof(uint32_t), FIELD_THRESHOLD, 0, 0);
 
-    uint8_t *keys = buffer += 3 * sizeof(name_t) + sizeof(uint32_t);
-    uint32_t keyBufferLength = bufferLength - 3 * sizeof(name_t) + sizeof(uint32_t);
-
-    uint32_t totalKeys = 0;
-    read = unpack_variant32(keys, keyBufferLength, &totalKeys);
-    keys += read; keyBufferLength -= read;
-    
-    uint8_t keysArgStart = 3;
-
-    if (keysArgStart < argNum && argNum <= keysArgStart + totalKeys * 2) {
-        for (uint8_t i = 0, argIndex = keysArgStart + 1; i < totalKeys; ++i, argIndex += 2) {
-            
-            char label[32] = { 0 };
-            // Skip key Type
-            keys += 1; keyBufferLength -= 1;
-            
-            if (argIndex == argNum) {
-                snprintf(label, sizeof(label), "Key #%d", (i + 1));
-                parsePublicKeyField(keys, keyBufferLength, label, arg, &read, &written);
-                return;
-            }
-
-            keys += sizeof(public_key_t); keyBufferLength -= sizeof(public_key_t);
-
-            if (argIndex + 1 == argNum) {
-                snprintf(label, sizeof(label), "Key #%d Weight", (i + 1));
-                parseUint16Field(keys, keyBufferLength, label, arg, &read, &written);
-                return;
-            }
-
-            keys += sizeof(uint16_t); keyBufferLength -= sizeof(uint16_t);
-        }
+    DECODE_LENGTH(d, ARGUMENT_ORDINAL_MAX);
+    for (d->total = d->value, d->count = 0; d->count < d->total; d->count++) {
+        // Key type and key
+        DECODE_ARGUMENT(d, 1 + sizeof(public_key_t), FIELD_KEY, d->count + 1, d->total);
+        DECODE_ARGUMENT(d, sizeof(uint16_t), FIELD_KEY_WEIGHT, d->count + 1, d->total);
     }
 
-    // Accounts
-    const uint32_t keyStep = (1 + sizeof(public_key_t) + sizeof(uint16_t));
-    uint8_t *accounts = keys + keyStep * totalKeys;
-    uint32_t accountsBufferLen = keyBufferLength - keyStep * totalKeys;
-    
-    uint32_t totalAccounts = 0;
-    read = unpack_variant32(accounts, accountsBufferLen, &totalAccounts);
-    accounts += read; accountsBufferLen -= read;
-    
-    uint32_t accountsArgStart = keysArgStart + totalKeys * 2;
-    
-    if (accountsArgStart < argNum && argNum <= accountsArgStart + totalAccounts * 2) {
-        for (uint8_t i = 0, argIndex = accountsArgStart + 1; i < totalAccounts; ++i, argIndex += 2) {
-            char label[32] = { 0 };
-            if (argIndex == argNum) {
-                snprintf(label, sizeof(label), "Account #%d", (i + 1));
-                parsePermissionField(accounts, accountsBufferLen, label, arg, &read, &written);
-                return;
-            }
-            
-            accounts += sizeof(permisssion_level_t); accountsBufferLen -= sizeof(permisssion_level_t);
-            
-            if (argIndex + 1 == argNum) {
-                snprintf(label, sizeof(label), "Account #%d Weight", (i + 1));
-                parseUint16Field(accounts, accountsBufferLen, label, arg, &read, &written);
-                return;
-            }
-            
-            accounts += sizeof(uint16_t); accountsBufferLen -= sizeof(uint16_t);
-        }
+    DECODE_LENGTH(d, ARGUMENT_ORDINAL_MAX);
+    for (d->total = d->value, d->count = 0; d->count < d->total; d->count++) {
+        DECODE_ARGUMENT(d, sizeof(permisssion_level_t), FIELD_AUTH_ACCOUNT, d->count + 1, d->total);
+        DECODE_ARGUMENT(d, sizeof(uint16_t), FIELD_AUTH_ACCOUNT_WEIGHT, d->count + 1, d->total);
     }
 
-    // Delays
-    const uint32_t accountStep = sizeof(permisssion_level_t) + sizeof(uint16_t);
-    uint8_t *delays = accounts + accountStep * totalAccounts;
-    uint32_t delayBufferLen = accountsBufferLen - accountStep * totalAccounts;
-
-    uint32_t totalDelays = 0;
-    read = unpack_variant32(delays, delayBufferLen, &totalDelays);
-    delays += read; delayBufferLen -= read;
-    
-    uint32_t delaysArgStart = keysArgStart + totalKeys * 2 + totalAccounts * 2;
-
-    if (delaysArgStart < argNum && argNum <= delaysArgStart + totalDelays * 2) {
-        for (uint8_t i = 0, argIndex = delaysArgStart + 1; i < totalDelays; ++i, argIndex += 2) {
-            char label[32] = { 0 };
-
-            if (argIndex == argNum) {
-                snprintf(label, sizeof(label), "Delay #%d", (i + 1));
-                parseUint32Field(delays, delayBufferLen, label, arg, &read, &written);
-                return;
-            }
-            
-            delays += sizeof(uint32_t); delayBufferLen -= sizeof(uint32_t);
-            
-            if (argIndex + 1 == argNum) {
-                snprintf(label, sizeof(label), "Delay #%d Weight", (i + 1));
-                parseUint16Field(delays, delayBufferLen, label, arg, &read, &written);
-                return;
-            }
-            
-            delays += sizeof(uint16_t); delayBufferLen -= sizeof(uint16_t);
-        }
+    DECODE_LENGTH(d, ARGUMENT_ORDINAL_MAX);
+    for (d->total = d->value, d->count = 0; d->count < d->total; d->count++) {
+        DECODE_ARGUMENT(d, sizeof(uint32_t), FIELD_DELAY, d->count + 1, d->total);
+        DECODE_ARGUMENT(d, sizeof(uint16_t), FIELD_DELAY_WEIGHT, d->count + 1, d->total);
     }
+    DECODER_END(d);
 }
 
-void parseDeleteAuth(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Account", arg, &read, &written);
-        return;
-    } 
-    
-    if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Permission", arg, &read, &written);
-        return;
-    }
+decoderStatus_e decodeDeleteAuth(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACCOUNT, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_PERMISSION, 0, 0);
+    DECODER_END(d);
 }
 
-void parseLinkAuth(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Account", arg, &read, &written);
-        return;
-    } 
-    
-    if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Contract", arg, &read, &written);
-        return;
-    }
-
-    if (argNum == 2) {
-        buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Action", arg, &read, &written);
-        return;
-    }
-
-    if (argNum == 3) {
-        buffer += 3 * sizeof(name_t); bufferLength -= 3 * sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Permission", arg, &read, &written);
-        return;
-    }
+decoderStatus_e decodeLinkAuth(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACCOUNT, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_CONTRACT, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACTION, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_PERMISSION, 0, 0);
+    DECODER_END(d);
 }
 
-void parseUnlinkAuth(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+decoderStatus_e decodeUnlinkAuth(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACCOUNT, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_CONTRACT, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACTION, 0, 0);
+    DECODER_END(d);
+}
 
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Account", arg, &read, &written);
-        return;
-    } 
-    
-    if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Contract", arg, &read, &written);
-        return;
-    }
+static uint32_t readUint32(uint8_t *buffer) {
+    uint32_t value = 0;
+    os_memmove(&value, buffer, sizeof(value));
+    return value;
+}
 
-    if (argNum == 2) {
-        buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Action", arg, &read, &written);
-        return;
-    }
+static uint16_t readUint16(uint8_t *buffer) {
+    uint16_t value = 0;
+    os_memmove(&value, buffer, sizeof(value));
+    return value;
 }
 
-void parseNewAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-    
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "Creator", arg, &read, &written);
-        return;
-    }
-    
-    if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "Account", arg, &read, &written);
-        return;
-    }
-    
-    // Offset to auth structures: owner, active
-    buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-    // offset to owner key; skip threshold
-    buffer += sizeof(uint32_t); bufferLength -= sizeof(uint32_t);
-    // skip key counter and key type
-    buffer += 2; bufferLength -= 2;
-    
-    if (argNum == 2) {
-        parsePublicKeyField(buffer, bufferLength, "Owner key", arg, &read, &written);
-        return;
-    }
-    // skip public key
-    buffer += sizeof(public_key_t) + sizeof(uint16_t); bufferLength -= sizeof(public_key_t) + sizeof(uint16_t);
-    // skip accounts, delays
-    // Offset to "active"
-    buffer += 2; bufferLength -= 2;
-    
-    // skip threshold
-    // offset to active key; skip threshold
-    buffer += sizeof(uint32_t); bufferLength -= sizeof(uint32_t);
-    // skip key counter and key type
-    buffer += 2; bufferLength -= 2;
-    
-    if (argNum == 3) {
-        parsePublicKeyField(buffer, bufferLength, "Active key", arg, &read, &written);
-        return;
+/**
+ * Owner and active authorities must be a single key with weight 1,
+ * no accounts and no delays.
+*/
+decoderStatus_e decodeNewAccount(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_CREATOR, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_ACCOUNT, 0, 0);
+
+    for (d->count = 0; d->count < 2; d->count++) {
+        DECODE_READ(d, sizeof(uint32_t));
+        if (readUint32(d->scratch) != 1) {
+            PRINTF("Threshold should be 1");
+            return DECODER_ERROR;
+        }
+        DECODE_VARINT(d);
+        if (d->value != 1) {
+            PRINTF("Authority key must be 1");
+            return DECODER_ERROR;
+        }
+        // Skip key type
+        DECODE_READ(d, 1);
+        DECODE_ARGUMENT(d, sizeof(public_key_t), d->count == 0 ? FIELD_OWNER_KEY : FIELD_ACTIVE_KEY, 0, 0);
+        DECODE_READ(d, sizeof(uint16_t));
+        if (readUint16(d->scratch) != 1) {
+            PRINTF("Authority key weight must be 1");
+            return DECODER_ERROR;
+        }
+        DECODE_VARINT(d);
+        if (d->value != 0) {
+            PRINTF("No accounts allowed");
+            return DECODER_ERROR;
+        }
+        DECODE_VARINT(d);
+        if (d->value != 0) {
+            PRINTF("No delays allowed");
+            return DECODER_ERROR;
+        }
     }
+    DECODER_END(d);
 }
@@ -18,19 +18,19 @@
 #ifndef __EOS_PARSE_EOSIO_H__
 #define __EOS_PARSE_EOSIO_H__
 
-#include "eos_parse.h"
+#include "eos_decoder.h"
 
-void parseDelegate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseUndelegate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseRefund(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseBuyRam(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseBuyRamBytes(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseSellRam(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseVoteProducer(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseUpdateAuth(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseDeleteAuth(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseLinkAuth(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseUnlinkAuth(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseNewAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+decoderStatus_e decodeDelegate(actionDecoder_t *decoder);
+decoderStatus_e decodeUndelegate(actionDecoder_t *decoder);
+decoderStatus_e decodeRefund(actionDecoder_t *decoder);
+decoderStatus_e decodeBuyRam(actionDecoder_t *decoder);
+decoderStatus_e decodeBuyRamBytes(actionDecoder_t *decoder);
+decoderStatus_e decodeSellRam(actionDecoder_t *decoder);
+decoderStatus_e decodeVoteProducer(actionDecoder_t *decoder);
+decoderStatus_e decodeUpdateAuth(actionDecoder_t *decoder);
+decoderStatus_e decodeDeleteAuth(actionDecoder_t *decoder);
+decoderStatus_e decodeLinkAuth(actionDecoder_t *decoder);
+decoderStatus_e decodeUnlinkAuth(actionDecoder_t *decoder);
+decoderStatus_e decodeNewAccount(actionDecoder_t *decoder);
 
 #endif
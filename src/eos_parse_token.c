@@ -17,21 +17,16 @@
 
 #include "eos_parse_token.h"
 #include "eos_types.h"
+#include "os.h"
 
-void parseTokenTransfer(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    if (argNum == 0) {
-        parseNameField(buffer, bufferLength, "From", arg, &read, &written);
-    } else if (argNum == 1) {
-        buffer += sizeof(name_t); bufferLength -= sizeof(name_t);
-        parseNameField(buffer, bufferLength, "To", arg, &read, &written);
-    } else if (argNum == 2) {
-        buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-        parseAssetField(buffer, bufferLength, "Quantity", arg, &read, &written);
-    } else if (argNum == 3) {
-        buffer += 2 * sizeof(name_t) + sizeof(asset_t); bufferLength -= 2 * sizeof(name_t) + sizeof(asset_t);
-        parseStringField(buffer, bufferLength, "Memo", arg, &read, &written);
+decoderStatus_e decodeTokenTransfer(actionDecoder_t *d) {
+    DECODER_BEGIN(d);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_FROM, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(name_t), FIELD_TO, 0, 0);
+    DECODE_ARGUMENT(d, sizeof(asset_t), FIELD_QUANTITY, 0, 0);
+    DECODE_LENGTH(d, STRING_MAX_LENGTH);
+    if (d->value > 0) {
+        DECODE_STRING(d, FIELD_MEMO, 0, 0);
     }
-}
\ No newline at end of file
+    DECODER_END(d);
+}
@@ -18,8 +18,8 @@
 #ifndef __EOS_PARSE_TOKEN_H__
 #define __EOS_PARSE_TOKEN_H__
 
-#include "eos_parse.h"
+#include "eos_decoder.h"
 
-void parseTokenTransfer(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+decoderStatus_e decodeTokenTransfer(actionDecoder_t *decoder);
 
-#endif
\ No newline at end of file
+#endif
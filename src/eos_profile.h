@@ -0,0 +1,73 @@
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __EOS_PROFILE_H__
+#define __EOS_PROFILE_H__
+
+#include <stdint.h>
+
+/**
+ * Per target RAM profile.
+ * Nano S keeps the minimal footprint: argument pages are small, so long
+ * actions are reviewed in more pages. Nano X has RAM to spare for larger
+ * pages. Argument data only holds values that straddle chunks, values
+ * whole within a chunk are referenced in place. Budgets are enforced at
+ * compile time for device targets (RAM_BUDGET_ASSERT), any growth of the
+ * parser or signing context has to be accounted for here.
+*/
+
+// Signing budget covers the parser context plus the transaction path,
+// both digests and the review content with its prefetched screens,
+// encoded keys and run summary
+
+#if defined(TARGET_NANOX)
+
+#define ARGUMENT_INDEX_SIZE 64
+#define ARGUMENT_DATA_SIZE 352
+#define PUBLIC_KEY_CACHE_SIZE 2
+#define SUMMARY_SYMBOLS 4
+
+#define TX_PROCESSING_RAM_BUDGET 1152
+#define SIGNING_RAM_BUDGET 2200
+
+#else
+
+#define ARGUMENT_INDEX_SIZE 32
+#define ARGUMENT_DATA_SIZE 160
+#define PUBLIC_KEY_CACHE_SIZE 1
+#define SUMMARY_SYMBOLS 2
+
+#define TX_PROCESSING_RAM_BUDGET 640
+#define SIGNING_RAM_BUDGET 1600
+
+#endif
+
+#if ARGUMENT_DATA_SIZE > 256
+typedef uint16_t argumentOffset_t;
+#else
+typedef uint8_t argumentOffset_t;
+#endif
+
+#if defined(TARGET_NANOS) || defined(TARGET_NANOX)
+#define RAM_BUDGET_ASSERT(type, budget) \
+    _Static_assert(sizeof(type) <= (budget), #type " exceeds " #budget)
+#else
+// Host builds have wider pointers, budgets only apply to devices
+#define RAM_BUDGET_ASSERT(type, budget)
+#endif
+
+#endif // __EOS_PROFILE_H__
@@ -15,6 +15,7 @@
 *  limitations under the License.
 ********************************************************************************/
 
+#include <stddef.h>
 #include <string.h>
 #include "eos_stream.h"
 #include "os.h"
@@ -25,730 +26,982 @@
 #include "eos_parse_token.h"
 #include "eos_parse_eosio.h"
 #include "eos_parse_unknown.h"
+#include "eos_parse_abi.h"
+#include "eos_decoder.h"
 
-#define EOSIO_TOKEN          0x5530EA033482A600
-#define EOSIO_TOKEN_TRANSFER 0xCDCD3C2D57000000
-
-#define EOSIO                0x5530EA0000000000
-#define EOSIO_DELEGATEBW     0x4AA2A61B2A3F0000
-#define EOSIO_UNDELEGATEBW   0xD4D2A8A986CA8FC0
-#define EOSIO_VOTEPRODUCER   0xDD32AADE89D21570
-#define EOSIO_BUYRAM         0x3EBD734800000000
-#define EOSIO_BUYRAMBYTES    0x3EBD7348FECAB000
-#define EOSIO_SELLRAM        0xC2A31B9A40000000
-#define EOSIO_UPDATE_AUTH    0xD5526CA8DACB4000
-#define EOSIO_DELETE_AUTH    0x4AA2ACA8DACB4000
-#define EOSIO_REFUND         0xBA97A9A400000000
-#define EOSIO_LINK_AUTH      0x8BA7036B2D000000
-#define EOSIO_UNLINK_AUTH    0xD4E2E9C0DACB4000
-#define EOSIO_NEW_ACCOUNT    0x9AB864229A9E4000
+RAM_BUDGET_ASSERT(txProcessingContext_t, TX_PROCESSING_RAM_BUDGET);
+
+/**
+ * Supported action: its data is decoded and reviewed argument by argument.
+ * Program is the bytecode offset of actions decoded by decodeAbi.
+*/
+typedef struct actionEntry_t {
+    name_t contract;
+    name_t action;
+    actionDecoder_f decode;
+    uint16_t program;
+} actionEntry_t;
+
+#include "eos_actions.h"
+
+// Registry contract matching any contract
+#define ANY_CONTRACT 0
+#define ACTION_UNKNOWN 0xFF
+
+// FNV-1a, only checks that the manifest describes the streamed actions
+#define MANIFEST_DIGEST_INIT 0x811C9DC5
+#define MANIFEST_DIGEST_PRIME 0x01000193
+
+// Actions, contract, action, sender and recipients come before the totals
+#define SUMMARY_SCREENS 5
+
+typedef enum summaryStep_e {
+    ACTION_REVIEW,
+    ACTION_FOLD,
+    ACTION_ENDS_RUN
+} summaryStep_e;
+
+// Prefetched screens share their bytes with the summary of an open run
+static bool screensPrefetched(const txProcessingContent_t *content) {
+    return content->summaryState == SUMMARY_OFF || content->summaryState == SUMMARY_IDLE;
+}
+
+static void dropScreens(txProcessingContent_t *content) {
+    uint8_t i;
+    content->printedArgument = SCREEN_NONE;
+    if (!screensPrefetched(content)) {
+        return;
+    }
+    for (i = 0; i < PREFETCH_SCREENS; ++i) {
+        content->prefetched[i].argNum = SCREEN_NONE;
+    }
+}
+
+/**
+ * New arguments are ready for review, screens of the previous ones are stale.
+*/
+static void setArgumentCount(txProcessingContext_t *context, uint8_t count) {
+    context->content->argumentCount = count;
+    dropScreens(context->content);
+}
 
 void initTxContext(txProcessingContext_t *context, 
                    cx_sha256_t *sha256, 
                    cx_sha256_t *dataSha256, 
                    txProcessingContent_t *processingContent,
-                   uint8_t dataAllowed) {
+                   uint8_t dataAllowed,
+                   txEncoding_e encoding) {
     os_memset(context, 0, sizeof(txProcessingContext_t));
     context->sha256 = sha256;
     context->dataSha256 = dataSha256;
     context->content = processingContent;
     context->state = TLV_CHAIN_ID;
     context->dataAllowed = dataAllowed;
+    context->encoding = encoding;
+    context->actionsDigest = MANIFEST_DIGEST_INIT;
+    context->content->summaryState = SUMMARY_OFF;
+    setArgumentCount(context, 0);
+    reset_public_key_cache(&context->content->keys);
     cx_sha256_init(context->sha256);
     cx_sha256_init(context->dataSha256);
 }
 
-uint8_t readTxByte(txProcessingContext_t *context) {
-    uint8_t data;
+void initTxParser(txParser_t *parser, uint8_t dataAllowed, txEncoding_e encoding) {
+    initTxContext(&parser->context, &parser->sha256, &parser->dataSha256, &parser->content, dataAllowed, encoding);
+}
+
+bool readTxByte(txProcessingContext_t *context, uint8_t *data) {
     if (context->commandLength < 1) {
         PRINTF("readTxByte Underflow\n");
-        THROW(EXCEPTION);
+        return false;
     }
-    data = *context->workBuffer;
+    *data = *context->workBuffer;
     context->workBuffer++;
     context->commandLength--;
-    return data;
+    return true;
 }
 
-static void processTokenTransfer(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    uint32_t bufferLength = context->currentActionDataBufferLength;
-    uint8_t *buffer = context->actionDataBuffer;
+static void processUnknownAction(txProcessingContext_t *context) {
+    cx_hash(&context->dataSha256->header, CX_LAST, context->dataChecksum, 0,
+            context->dataChecksum, sizeof(context->dataChecksum));
+    setArgumentCount(context, 3);
+}
 
-    buffer += 2 * sizeof(name_t) + sizeof(asset_t); 
-    bufferLength -= 2 * sizeof(name_t) + sizeof(asset_t);
-    uint32_t memoLength = 0;
-    unpack_variant32(buffer, bufferLength, &memoLength);
-    if (memoLength > 0) {
-        context->content->argumentCount++;
+/**
+ * Summary screens: actions of the run, their contract, action and sender,
+ * recipient count, then one total per symbol.
+*/
+static bool renderSummary(const txSummary_t *summary, uint8_t screen, actionArgument_t *arg) {
+    uint32_t written;
+    asset_t total;
+
+    os_memset(arg, 0, sizeof(actionArgument_t));
+    switch (screen) {
+    case 0:
+        format_label(arg->label, sizeof(arg->label), "Actions", 0, 0);
+        format_label(arg->data, sizeof(arg->data), "#%d to #%d", summary->first, summary->first + summary->actions - 1);
+        return true;
+    case 1:
+        format_label(arg->label, sizeof(arg->label), "Contract", 0, 0);
+        return name_to_string(summary->contract, arg->data, sizeof(arg->data), &written);
+    case 2:
+        format_label(arg->label, sizeof(arg->label), "Action", 0, 0);
+        return name_to_string(summary->action, arg->data, sizeof(arg->data), &written);
+    case 3:
+        format_label(arg->label, sizeof(arg->label), "From", 0, 0);
+        return name_to_string(summary->from, arg->data, sizeof(arg->data), &written);
+    case 4:
+        format_label(arg->label, sizeof(arg->label), "Recipients", 0, 0);
+        format_label(arg->data, sizeof(arg->data), "%d", summary->actions, 0);
+        return true;
+    default:
+        screen -= SUMMARY_SCREENS;
+        if (screen >= summary->symbols) {
+            PRINTF("renderSummary Invalid screen\n");
+            return false;
+        }
+        format_label(arg->label, sizeof(arg->label), summary->symbols > 1 ? "Total #%d" : "Total", screen + 1, 0);
+        os_memmove(&total, &summary->totals[screen], sizeof(asset_t));
+        return asset_to_string(&total, arg->data, sizeof(arg->data) - 1, &written);
     }
 }
 
-static void processEosioDelegate(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;
-    uint32_t bufferLength = context->currentActionDataBufferLength;
-    uint8_t *buffer = context->actionDataBuffer;
+static bool renderArgument(txProcessingContext_t *context, uint8_t argNum, actionArgument_t *arg) {
+    if (context->content->summaryState == SUMMARY_REVIEW) {
+        return renderSummary(&context->content->summary, argNum, arg);
+    }
+    if (context->knownAction) {
+        return parseIndexedArgument(&context->argumentIndex, currentAbiDescriptor(context), &context->content->keys,
+                                    argNum, arg);
+    }
+    
+    if (context->dataAllowed == 1) {
+        parseUnknownAction(context->dataChecksum, sizeof(context->dataChecksum), argNum, arg);
+    }
+    return true;
+}
 
-    buffer += 2 * sizeof(name_t) + 2 * sizeof(asset_t);
-    bufferLength -= 2 * sizeof(name_t) + 2 * sizeof(asset_t);
+bool printArgument(uint8_t argNum, txProcessingContext_t *context) {
+    txProcessingContent_t *content = context->content;
+    uint8_t i;
 
-    if (buffer[0] != 0) {
-        context->content->argumentCount += 1;
+    if (argNum == content->printedArgument) {
+        return true;
     }
+    for (i = 0; i < PREFETCH_SCREENS && screensPrefetched(content); ++i) {
+        if (content->prefetched[i].argNum == argNum) {
+            // The screen left is a neighbour of the new one, the other
+            // prefetched screen is not any more
+            prefetchedScreen_t *other = &content->prefetched[1 - i];
+            other->argNum = content->printedArgument;
+            if (other->argNum != SCREEN_NONE) {
+                os_memmove(&other->arg, &content->arg, sizeof(actionArgument_t));
+            }
+            os_memmove(&content->arg, &content->prefetched[i].arg, sizeof(actionArgument_t));
+            content->prefetched[i].argNum = SCREEN_NONE;
+            content->printedArgument = argNum;
+            return true;
+        }
+    }
+    content->printedArgument = SCREEN_NONE;
+    if (!renderArgument(context, argNum, &content->arg)) {
+        return false;
+    }
+    content->printedArgument = argNum;
+    return true;
 }
 
-static void processEosioUndelegate(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;
+static bool isPrefetched(const txProcessingContent_t *content, uint8_t argNum) {
+    uint8_t i;
+    for (i = 0; i < PREFETCH_SCREENS; ++i) {
+        if (content->prefetched[i].argNum == argNum) {
+            return true;
+        }
+    }
+    return false;
 }
 
-static void processEosioRefund(txProcessingContext_t *context) {
-    context->content->argumentCount = 1;
+bool prefetchArgument(txProcessingContext_t *context) {
+    txProcessingContent_t *content = context->content;
+    uint8_t count = content->argumentCount;
+    // Before the first argument is printed its next one is the first
+    uint8_t next = content->printedArgument + 1;
+    uint8_t previous = content->printedArgument - 1;
+    uint8_t wanted;
+    uint8_t slot;
+
+    if (!screensPrefetched(content)) {
+        return false;
+    }
+    if (next < count && !isPrefetched(content, next)) {
+        wanted = next;
+    } else if (previous < count && !isPrefetched(content, previous)) {
+        wanted = previous;
+    } else {
+        return false;
+    }
+    // Reuse the screen that is neither neighbour
+    for (slot = 0; slot < PREFETCH_SCREENS - 1; ++slot) {
+        if (content->prefetched[slot].argNum != next && content->prefetched[slot].argNum != previous) {
+            break;
+        }
+    }
+    content->prefetched[slot].argNum = SCREEN_NONE;
+    if (!renderArgument(context, wanted, &content->prefetched[slot].arg)) {
+        return false;
+    }
+    content->prefetched[slot].argNum = wanted;
+    return true;
 }
 
-static void processEosioBuyRam(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
+static uint8_t searchAction(name_t contractName, name_t actionName) {
+    uint8_t low = 0;
+    uint8_t high = ACTION_REGISTRY_SIZE;
+    const actionEntry_t *entry;
+    while (low < high) {
+        uint8_t middle = (low + high) / 2;
+        entry = (const actionEntry_t *)PIC(&actionRegistry[middle]);
+        if (entry->contract < contractName || 
+            (entry->contract == contractName && entry->action < actionName)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == ACTION_REGISTRY_SIZE) {
+        return ACTION_UNKNOWN;
+    }
+    entry = (const actionEntry_t *)PIC(&actionRegistry[low]);
+    return (entry->contract == contractName && entry->action == actionName) ? low : ACTION_UNKNOWN;
 }
 
-static void processEosioSellRam(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
+/**
+ * Registry index of the action, ACTION_UNKNOWN if it is not supported.
+ * Actions with an uploaded descriptor follow the registry, 
+ * ACTION_REGISTRY_SIZE + descriptor slot.
+*/
+static uint8_t findAction(const abiDescriptorStore_t *descriptors, name_t contractName, name_t actionName) {
+    uint8_t index = searchAction(contractName, actionName);
+    if (index == ACTION_UNKNOWN) {
+        index = searchAction(ANY_CONTRACT, actionName);
+    }
+    if (index == ACTION_UNKNOWN) {
+        uint8_t slot = findAbiDescriptor(descriptors, contractName, actionName);
+        if (slot != ABI_DESCRIPTOR_NONE) {
+            index = ACTION_REGISTRY_SIZE + slot;
+        }
+    }
+    return index;
 }
 
-static void processEosioVoteProducer(txProcessingContext_t *context) {
-    uint32_t bufferLength = context->currentActionDataBufferLength;
-    uint8_t *buffer = context->actionDataBuffer;
-
-    context->content->argumentCount = 1;
-    buffer += sizeof(name_t);
-
-    name_t proxy = 0;
-    os_memmove(&proxy, buffer, sizeof(name_t));
-    if (proxy != 0) {
-        context->content->argumentCount++;
-        return;
+const abiDescriptor_t *currentAbiDescriptor(const txProcessingContext_t *context) {
+    if (!context->knownAction || context->registryIndex < ACTION_REGISTRY_SIZE) {
+        return NULL;
     }
-    buffer += sizeof(name_t);
-
-    uint32_t totalProducers = 0;
-    unpack_variant32(buffer, bufferLength, &totalProducers);
-    context->content->argumentCount += totalProducers;
+    return &context->descriptors->slots[context->registryIndex - ACTION_REGISTRY_SIZE];
 }
 
-static void processEosioUpdateAuth(txProcessingContext_t *context) {
-    uint32_t bufferLength = context->currentActionDataBufferLength;
-    uint8_t *buffer = context->actionDataBuffer;
-
-    context->content->argumentCount = 4;
-
-    buffer += 3 * sizeof(name_t) + sizeof(uint32_t);
-    bufferLength -= 3 * sizeof(name_t) + sizeof(uint32_t);
-
-    uint32_t totalKeys = 0;
-    uint32_t read = unpack_variant32(buffer, bufferLength, &totalKeys);
-    context->content->argumentCount += totalKeys * 2;
-
-    // keys data begins here
-    buffer += read; bufferLength -= read;
-    buffer += (1 + sizeof(public_key_t) + sizeof(uint16_t)) * totalKeys;
+static uint32_t manifestFold(uint32_t digest, const uint8_t *buffer, uint32_t length) {
+    while (length--) {
+        digest = (digest ^ *buffer++) * MANIFEST_DIGEST_PRIME;
+    }
+    return digest;
+}
 
-    uint32_t totalAccounts = 0;
-    read = unpack_variant32(buffer, bufferLength, &totalAccounts);
-    context->content->argumentCount += totalAccounts * 2;
+bool checkTxManifest(const uint8_t *buffer, uint32_t length, uint8_t dataAllowed, 
+                     const abiDescriptorStore_t *descriptors, txManifest_t *manifest) {
+    uint32_t digest = MANIFEST_DIGEST_INIT;
+    uint8_t i;
+    if (length < 2 || buffer[0] != 0) {
+        PRINTF("checkTxManifest Context free actions\n");
+        return false;
+    }
+    if (buffer[1] == 0 || buffer[1] > MAX_MANIFEST_ACTIONS || 
+        length != 2 + buffer[1] * MANIFEST_ENTRY_SIZE) {
+        PRINTF("checkTxManifest Invalid action count\n");
+        return false;
+    }
+    for (i = 0; i < buffer[1]; ++i) {
+        const uint8_t *entry = buffer + 2 + i * MANIFEST_ENTRY_SIZE;
+        name_t contractName;
+        name_t actionName;
+        os_memmove(&contractName, entry, sizeof(name_t));
+        os_memmove(&actionName, entry + sizeof(name_t), sizeof(name_t));
+        if (dataAllowed != 1 && findAction(descriptors, contractName, actionName) == ACTION_UNKNOWN) {
+            PRINTF("checkTxManifest Unknown action\n");
+            return false;
+        }
+        digest = manifestFold(digest, entry, MANIFEST_ENTRY_SIZE);
+    }
+    manifest->actions = buffer[1];
+    manifest->digest = digest;
+    return true;
+}
 
-    // accounts data begins here
-    buffer += read; bufferLength -= read;
-    buffer += (sizeof(permisssion_level_t) + sizeof(uint16_t)) * totalAccounts;
+void setTxManifest(txProcessingContext_t *context, const txManifest_t *manifest) {
+    context->manifestActions = manifest->actions;
+    context->manifestDigest = manifest->digest;
+}
 
-    uint32_t totalWaits = 0;
-    read = unpack_variant32(buffer, bufferLength, &totalWaits);
-    context->content->argumentCount += totalWaits * 2; 
+void setTxDescriptors(txProcessingContext_t *context, const abiDescriptorStore_t *descriptors) {
+    context->descriptors = descriptors;
 }
 
-static void processEosioDeleteAuth(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;  
+void setTxSummary(txProcessingContext_t *context, bool enabled) {
+    context->content->summaryState = (enabled ? SUMMARY_IDLE : SUMMARY_OFF);
+    dropScreens(context->content);
 }
 
-static void processEosioLinkAuth(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;  
+/**
+ * Sender, recipient and quantity of a completed action that may be part
+ * of a run: its arguments start with one of each. Pages are not, part of
+ * their action is reviewed on its own.
+*/
+static bool readRunAction(txProcessingContext_t *context, name_t *from, name_t *to, asset_t *quantity) {
+    const argumentIndex_t *index = &context->argumentIndex;
+
+    if (!context->knownAction || context->actionPage || index->count < 3 ||
+        index->entries[0].field != FIELD_FROM || index->entries[0].size != sizeof(name_t) ||
+        index->entries[1].field != FIELD_TO || index->entries[1].size != sizeof(name_t) ||
+        index->entries[2].field != FIELD_QUANTITY || index->entries[2].size != sizeof(asset_t)) {
+        return false;
+    }
+    os_memmove(quantity, indexedArgumentValue(index, 2), sizeof(asset_t));
+    return buffer_to_name_type((uint8_t *)indexedArgumentValue(index, 0), sizeof(name_t), from) &&
+           buffer_to_name_type((uint8_t *)indexedArgumentValue(index, 1), sizeof(name_t), to);
 }
 
-static void processEosioUnlinkAuth(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;  
+/**
+ * Adds quantity to the total of its symbol. False when a new symbol does
+ * not fit or the total would overflow, the action then starts a new run.
+*/
+static bool addSummaryTotal(txSummary_t *summary, const asset_t *quantity) {
+    uint8_t i;
+    for (i = 0; i < summary->symbols; ++i) {
+        if (summary->totals[i].symbol == quantity->symbol) {
+            break;
+        }
+    }
+    if (i == summary->symbols) {
+        if (i == SUMMARY_SYMBOLS) {
+            return false;
+        }
+        summary->totals[i].symbol = quantity->symbol;
+        summary->totals[i].amount = 0;
+        summary->symbols++;
+    }
+    int64_t total = summary->totals[i].amount;
+    if ((quantity->amount > 0 && total > INT64_MAX - quantity->amount) ||
+        (quantity->amount < 0 && total < INT64_MIN - quantity->amount)) {
+        return false;
+    }
+    summary->totals[i].amount = total + quantity->amount;
+    return true;
 }
 
-static void processUnknownAction(txProcessingContext_t *context) {
-    cx_hash(&context->dataSha256->header, CX_LAST, context->dataChecksum, 0,
-            context->dataChecksum, sizeof(context->dataChecksum));
-    context->content->argumentCount = 3;  
+/**
+ * The reviewed action opens a run if it may be part of one, otherwise
+ * screens are prefetched again.
+*/
+static void startRun(txProcessingContext_t *context) {
+    txProcessingContent_t *content = context->content;
+    txSummary_t *summary = &content->summary;
+    name_t from;
+    name_t to;
+    asset_t quantity;
+
+    // The action is already counted as completed
+    if (context->currentActionIndex <= UINT16_MAX && readRunAction(context, &from, &to, &quantity)) {
+        content->summaryState = SUMMARY_RUN;
+        summary->symbols = 0;
+        addSummaryTotal(summary, &quantity);
+        summary->contract = context->contractName;
+        summary->action = context->contractActionName;
+        summary->from = from;
+        summary->lastTo = to;
+        summary->first = context->currentActionIndex;
+        summary->actions = 1;
+    } else {
+        content->summaryState = SUMMARY_IDLE;
+        dropScreens(content);
+    }
 }
 
-static void processEosioNewAccountAction(txProcessingContext_t *context) {
-    uint8_t *buffer = context->actionDataBuffer;
-    uint32_t bufferLength = context->currentActionDataBufferLength;
-    
-    // Offset to auth structures: owner, active
-    buffer += 2 * sizeof(name_t); bufferLength -= 2 * sizeof(name_t);
-    
-    // Read owner key threshold
-    uint32_t threshold = 0;
-    os_memmove(&threshold, buffer, sizeof(threshold));
-    if (threshold != 1) {
-        PRINTF("Owner Threshold should be 1");
-        THROW(EXCEPTION);
-    }
-    buffer += sizeof(threshold); bufferLength -= sizeof(threshold);
-    
-    uint32_t size = 0;
-    uint32_t read = unpack_variant32(buffer, bufferLength, &size);
-    if (size != 1) {
-        PRINTF("Owner key must be 1");
-        THROW(EXCEPTION);
-    }
-    buffer += read; bufferLength -= read;
-    // Offset to key weight
-    buffer += 1 + sizeof(public_key_t); bufferLength -= 1 + sizeof(public_key_t);
-    uint16_t weight = 0;
-    os_memmove(&weight, buffer, sizeof(weight));
-    if (weight != 1) {
-        PRINTF("Owner key weight must be 1");
-        THROW(EXCEPTION);
-    }
-    buffer += sizeof(weight); bufferLength -= sizeof(weight);
-    
-    read = unpack_variant32(buffer, bufferLength, &size);
-    if (size != 0) {
-        PRINTF("No accounts allowed");
-        THROW(EXCEPTION);
+/**
+ * Recipients have to be in ascending name order to keep the run going,
+ * so each one is counted once.
+*/
+static bool foldAction(txProcessingContext_t *context, txSummary_t *summary) {
+    name_t from;
+    name_t to;
+    asset_t quantity;
+    if (!readRunAction(context, &from, &to, &quantity) || from != summary->from || to <= summary->lastTo ||
+        context->contractName != summary->contract || context->contractActionName != summary->action ||
+        summary->actions == UINT16_MAX) {
+        return false;
     }
-    buffer += read; bufferLength -= read;
-    read = unpack_variant32(buffer, bufferLength, &size);
-    if (size != 0) {
-        PRINTF("No delays allowed");
-        THROW(EXCEPTION);
+    if (!addSummaryTotal(summary, &quantity)) {
+        return false;
     }
-    buffer += read; bufferLength -= read;
-    
-    // process Active authorization
-    // -----------------------------------
-    
-    os_memmove(&threshold, buffer, sizeof(threshold));
-    if (threshold != 1) {
-        PRINTF("Active Threshold should be 1");
-        THROW(EXCEPTION);
+    summary->lastTo = to;
+    summary->actions++;
+    return true;
+}
+
+/**
+ * Summary screens replace the arguments until the next action is ready.
+*/
+static void reportSummary(txProcessingContext_t *context) {
+    txProcessingContent_t *content = context->content;
+    content->summary.pendingCount = content->argumentCount;
+    content->summaryState = SUMMARY_REVIEW;
+    setArgumentCount(context, SUMMARY_SCREENS + content->summary.symbols);
+}
+
+/**
+ * Summary mode: a ready action is totalled into the open run, or ends a 
+ * run of several actions reported before it, or is reviewed and may open
+ * a new run.
+*/
+static summaryStep_e summarizeAction(txProcessingContext_t *context) {
+    txProcessingContent_t *content = context->content;
+    txSummary_t *summary = &content->summary;
+
+    if (content->summaryState == SUMMARY_OFF) {
+        return ACTION_REVIEW;
     }
-    buffer += sizeof(threshold); bufferLength -= sizeof(threshold);
-    
-    read = unpack_variant32(buffer, bufferLength, &size);
-    if (size != 1) {
-        PRINTF("Active key must be 1");
-        THROW(EXCEPTION);
-    }
-    buffer += read; bufferLength -= read;
-    // Offset to key weight
-    buffer += 1 + sizeof(public_key_t); bufferLength -= 1 + sizeof(public_key_t);
-    weight = 0;
-    os_memmove(&weight, buffer, sizeof(weight));
-    if (weight != 1) {
-        PRINTF("Active key weight must be 1");
-        THROW(EXCEPTION);
-    }
-    buffer += sizeof(weight); bufferLength -= sizeof(weight);
-    
-    read = unpack_variant32(buffer, bufferLength, &size);
-    if (size != 0) {
-        PRINTF("No accounts allowed");
-        THROW(EXCEPTION);
+    if (content->summaryState == SUMMARY_REVIEW) {
+        // The run has been reviewed, the action that ended it follows
+        setArgumentCount(context, summary->pendingCount);
+    } else if (content->summaryState == SUMMARY_RUN) {
+        if (foldAction(context, summary)) {
+            return ACTION_FOLD;
+        }
+        if (summary->actions > 1) {
+            reportSummary(context);
+            return ACTION_ENDS_RUN;
+        }
     }
-    buffer += read; bufferLength -= read;
-    read = unpack_variant32(buffer, bufferLength, &size);
-    if (size != 0) {
-        PRINTF("No delays allowed");
-        THROW(EXCEPTION);
+    startRun(context);
+    return ACTION_REVIEW;
+}
+
+/**
+ * Resume known action decoder with the bytes available in decoder input.
+*/
+static decoderStatus_e runActionDecoder(txProcessingContext_t *context) {
+    if (context->registryIndex >= ACTION_REGISTRY_SIZE) {
+        return decodeAbi(&context->decoder);
     }
-    buffer += read; bufferLength -= read;
-    
-    context->content->argumentCount = 4;
+    const actionEntry_t *entry = (const actionEntry_t *)PIC(&actionRegistry[context->registryIndex]);
+    return ((actionDecoder_f)PIC(entry->decode))(&context->decoder);
 }
 
-void printArgument(uint8_t argNum, txProcessingContext_t *context) {
-    name_t contractName = context->contractName;
-    name_t actionName = context->contractActionName;
-    uint8_t *buffer = context->actionDataBuffer;
-    uint32_t bufferLength = context->currentActionDataBufferLength;
-    actionArgument_t *arg =  &context->content->arg;
+/**
+ * Feed a chunk of known action data to its decoder. Arguments are decoded
+ * as data arrives, when the argument store fills up the decoded page is 
+ * handed over for review and decoding resumes afterwards.
+ * Length is updated to the number of consumed bytes.
+*/
+static bool decodeActionData(txProcessingContext_t *context, uint8_t *buffer, uint32_t *length) {
+    actionDecoder_t *decoder = &context->decoder;
 
-    if (actionName == EOSIO_TOKEN_TRANSFER) {
-        parseTokenTransfer(buffer, bufferLength, argNum, arg);
-        return;
+    if (context->actionDecoded) {
+        if (*length != 0) {
+            PRINTF("decodeActionData Trailing data\n");
+            return false;
+        }
+        return true;
+    }
+    if (context->actionPage) {
+        context->actionPage = false;
+        resetArgumentIndex(&context->argumentIndex);
     }
 
-    if (contractName == EOSIO) {
-        switch (actionName) {
-        case EOSIO_DELEGATEBW:
-            parseDelegate(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_UNDELEGATEBW:
-            parseUndelegate(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_REFUND:
-            parseRefund(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_BUYRAM:
-            parseBuyRam(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_BUYRAMBYTES:
-            parseBuyRamBytes(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_SELLRAM:
-            parseSellRam(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_VOTEPRODUCER:
-            parseVoteProducer(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_UPDATE_AUTH:
-            parseUpdateAuth(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_DELETE_AUTH:
-            parseDeleteAuth(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_LINK_AUTH:
-            parseLinkAuth(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_UNLINK_AUTH:
-            parseUnlinkAuth(buffer, bufferLength, argNum, arg);
-            break;
-        case EOSIO_NEW_ACCOUNT:
-            parseNewAccount(buffer, bufferLength, argNum, arg);
-            break;
-        default:
-            if (context->dataAllowed == 1) {
-                parseUnknownAction(context->dataChecksum, sizeof(context->dataChecksum), argNum, arg);
-            }
+    decoder->in = buffer;
+    decoder->inLength = *length;
+    decoderStatus_e status = runActionDecoder(context);
+    if (status == DECODER_MORE) {
+        // Action data continues in the next chunk
+        if (decoderReleaseChunk(decoder) == DECODER_PAGE) {
+            status = DECODER_PAGE;
         }
-        return;
     }
-    
-    if (context->dataAllowed == 1) {
-        parseUnknownAction(context->dataChecksum, sizeof(context->dataChecksum), argNum, arg);
+    if (status == DECODER_PAGE) {
+        setArgumentCount(context, context->argumentIndex.count);
+        context->actionPage = true;
+        context->actionReady = true;
+    } else if (status == DECODER_DONE) {
+        context->actionDecoded = true;
+        if (decoder->inLength != 0) {
+            PRINTF("decodeActionData Trailing data\n");
+            return false;
+        }
+    } else if (status == DECODER_ERROR) {
+        return false;
     }
+
+    *length -= decoder->inLength;
+    return true;
 }
 
-static bool isKnownAction(txProcessingContext_t *context) {
-    name_t contractName = context->contractName;
-    name_t actionName = context->contractActionName;
-    if (actionName == EOSIO_TOKEN_TRANSFER) {
-        return true;
-    }
+#ifdef HAVE_HASH_STATS
+#define HASH_STAT(counter) (context->hashStats.counter++)
+#else
+#define HASH_STAT(counter)
+#endif
+
+static void updateTxHash(txProcessingContext_t *context, uint8_t *buffer, uint32_t length) {
+    cx_hash(&context->sha256->header, 0, buffer, length, NULL, 0);
+    HASH_STAT(hashCalls);
+}
 
-    if (contractName == EOSIO) {
-        switch (actionName) {
-        case EOSIO_DELEGATEBW:
-        case EOSIO_UNDELEGATEBW:
-        case EOSIO_REFUND:
-        case EOSIO_BUYRAM:
-        case EOSIO_BUYRAMBYTES:
-        case EOSIO_SELLRAM:
-        case EOSIO_VOTEPRODUCER:
-        case EOSIO_UPDATE_AUTH:
-        case EOSIO_DELETE_AUTH:
-        case EOSIO_LINK_AUTH:
-        case EOSIO_UNLINK_AUTH:
-        case EOSIO_NEW_ACCOUNT:
-            return true;   
-        } 
+/**
+ * Hash staged transaction bytes. Must be done before the transaction
+ * digest is finalized.
+*/
+static void flushTxHash(txProcessingContext_t *context) {
+    if (context->hashBufferLength != 0) {
+        updateTxHash(context, context->hashBuffer, context->hashBufferLength);
+        context->hashBufferLength = 0;
     }
-    return false;
 }
 
 /**
  * Sequentially hash an incoming data.
  * Hash functionality is moved out here in order to reduce 
  * dependencies on specific hash implementation.
+ * Most fields are a few bytes long and every cx_hash call is a syscall,
+ * so small fragments are staged and hashed by whole SHA-256 blocks.
 */
 static void hashTxData(txProcessingContext_t *context, uint8_t *buffer, uint32_t length) {
-    cx_hash(&context->sha256->header, 0, buffer, length, NULL, 0);
+    HASH_STAT(hashUpdates);
+
+    if (length >= sizeof(context->hashBuffer)) {
+        // Large fragments gain nothing from staging
+        flushTxHash(context);
+        updateTxHash(context, buffer, length);
+        return;
+    }
+
+    uint32_t staged = context->hashBufferLength;
+    uint32_t fill = sizeof(context->hashBuffer) - staged;
+    if (length < fill) {
+        os_memmove(context->hashBuffer + staged, buffer, length);
+        context->hashBufferLength += length;
+        return;
+    }
+
+    // Complete the staged block and keep the rest of the fragment
+    os_memmove(context->hashBuffer + staged, buffer, fill);
+    updateTxHash(context, context->hashBuffer, sizeof(context->hashBuffer));
+    os_memmove(context->hashBuffer, buffer + fill, length - fill);
+    context->hashBufferLength = length - fill;
+}
+
+void setTxChainId(txProcessingContext_t *context, const uint8_t *chainId) {
+    hashTxData(context, (uint8_t *)chainId, sizeof(checksum256));
+    context->state = TLV_HEADER_EXPITATION;
 }
 
 static void hashActionData(txProcessingContext_t *context, uint8_t *buffer, uint32_t length) {
     cx_hash(&context->dataSha256->header, 0, buffer, length, NULL, 0);
+    HASH_STAT(dataHashCalls);
 }
 
 /**
- * Process all fields that do not requre any processing except hashing.
- * The data comes in by chucks, so it may happen that buffer may contain 
- * incomplete data for particular field. Function designed to process 
- * everything until it receives all data for a particular field 
- * and after that will move to next field.
+ * Read a size field cached in sizeBuffer and reset the buffer,
+ * so the next size field is decoded from a clean state.
+ * The varint has to end exactly with the field, a truncated or padded
+ * one is malformed.
 */
-static void processField(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
-
-        hashTxData(context, context->workBuffer, length);
-
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
+static bool takeSizeField(txProcessingContext_t *context, uint32_t *size) {
+    uint32_t sizeValue = 0;
+    uint32_t read = unpack_variant32(context->sizeBuffer, context->currentFieldLength, &sizeValue);
+    bool complete = (read == context->currentFieldLength && (context->sizeBuffer[read - 1] & 0x80) == 0);
+    os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
+    if (!complete) {
+        PRINTF("takeSizeField Malformed size\n");
+        return false;
     }
+    *size = sizeValue;
+    return true;
+}
 
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->state++;
-        context->processingField = false;
+/**
+ * Size fields that are expected to have Zero value.
+ * Fail if number is not '0'.
+*/
+static bool onZeroSizeField(txProcessingContext_t *context) {
+    uint32_t size;
+    if (!takeSizeField(context, &size)) {
+        return false;
     }
+    if (size != 0) {
+        PRINTF("processCtxFreeAction Action Number must be 0\n");
+        return false;
+    }
+    context->state++;
+    return true;
 }
 
 /**
- * Process Size fields that are expected to have Zero value. Except hashing the data, function
- * caches an incomming data. So, when all bytes for particulat field are received
- * do additional processing: Read actual number of actions encoded in buffer.
- * Throw exception if number is not '0'.
+ * Read actual number of actions encoded in buffer.
 */
-static void processZeroSizeField(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
-
-        hashTxData(context, context->workBuffer, length);
-
-        // Store data into a buffer
-        os_memmove(context->sizeBuffer + context->currentFieldPos, context->workBuffer, length);
-
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
+static bool onActionListSize(txProcessingContext_t *context) {
+    if (!takeSizeField(context, &context->currentActionNumer)) {
+        return false;
     }
-
-    if (context->currentFieldPos == context->currentFieldLength) {
-        uint32_t sizeValue = 0;
-        unpack_variant32(context->sizeBuffer, context->currentFieldPos + 1, &sizeValue);
-        if (sizeValue != 0) {
-            PRINTF("processCtxFreeAction Action Number must be 0\n");
-            THROW(EXCEPTION);
-        }
-        // Reset size buffer
-        os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
-
-        // Move to next state
-        context->state++;
-        context->processingField = false;
+    context->currentActionIndex = 0;
+    context->state++;
+    if (context->manifestActions != 0 && context->manifestActions != context->currentActionNumer) {
+        PRINTF("onActionListSize Manifest mismatch\n");
+        return false;
+    }
+    if (context->currentActionNumer > 1) {
+        context->confirmProcessing = true;
     }
+    return true;
 }
 
 /**
- * Process Action Number Field. Except hashing the data, function
- * caches an incomming data. So, when all bytes for particulat field are received
- * do additional processing: Read actual number of actions encoded in buffer.
+ * Contract name is cached in order to display it for validation.
 */
-static void processActionListSizeField(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
+static bool onActionAccount(txProcessingContext_t *context) {
+    uint32_t written;
+    context->state++;
 
-        hashTxData(context, context->workBuffer, length);
+    os_memset(context->content->contract, 0, sizeof(context->content->contract));
+    return name_to_string(context->contractName, context->content->contract, sizeof(context->content->contract), &written);
+}
 
-        // Store data into a buffer
-        os_memmove(context->sizeBuffer + context->currentFieldPos, context->workBuffer, length);
+/**
+ * Action name is cached in order to display it for validation.
+ * Contract and action are known at this point, so action data
+ * processing is selected once per action.
+*/
+static bool onActionName(txProcessingContext_t *context) {
+    uint32_t written;
+    context->state++;
 
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
+    os_memset(context->content->action, 0, sizeof(context->content->action));
+    if (!name_to_string(context->contractActionName, context->content->action, sizeof(context->content->action), &written)) {
+        return false;
     }
-
-    if (context->currentFieldPos == context->currentFieldLength) {
-        unpack_variant32(context->sizeBuffer, context->currentFieldPos + 1, &context->currentActionNumer);
-        context->currentActionIndex = 0;
-        
-        // Reset size buffer
-        os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
-
-        context->state++;
-        context->processingField = false;
-        if (context->currentActionNumer > 1) {
-            context->confirmProcessing = true;
+    context->registryIndex = findAction(context->descriptors, context->contractName, context->contractActionName);
+    context->knownAction = (context->registryIndex != ACTION_UNKNOWN);
+    context->actionsDigest = manifestFold(context->actionsDigest, (uint8_t *)&context->contractName, sizeof(name_t));
+    context->actionsDigest = manifestFold(context->actionsDigest, (uint8_t *)&context->contractActionName, sizeof(name_t));
+    if (context->knownAction) {
+        initActionDecoder(&context->decoder, &context->argumentIndex);
+        if (context->registryIndex >= ACTION_REGISTRY_SIZE) {
+            context->decoder.program = currentAbiDescriptor(context)->program;
+        } else {
+            const actionEntry_t *entry = (const actionEntry_t *)PIC(&actionRegistry[context->registryIndex]);
+            initAbiDecoder(&context->decoder, entry->program);
         }
+        context->actionDecoded = false;
     }
+    return true;
 }
 
 /**
- * Process Action Account Field. Cache a data of the field in order to 
- * display it for validation.
+ * Initialize context authorization index and authorization number.
 */
-static void processActionAccount(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
-
-        hashTxData(context, context->workBuffer, length);
-        
-        uint8_t *pContract = (uint8_t *)&context->contractName;
-        os_memmove(pContract + context->currentFieldPos, context->workBuffer, length);
-
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
+static bool onAuthorizationListSize(txProcessingContext_t *context) {
+    if (!takeSizeField(context, &context->currentAutorizationNumber)) {
+        return false;
     }
+    context->currentAutorizationIndex = 0;
+    context->state++;
+    return true;
+}
 
-    if (context->currentFieldPos == context->currentFieldLength) {
+/**
+ * Start over authorization processing if there is data for that.
+*/
+static bool onAuthorizationPermission(txProcessingContext_t *context) {
+    context->currentAutorizationIndex++;
+    // Start over reading Authorization data or move to the next state
+    // if all authorization data have beed read
+    if (context->currentAutorizationIndex != context->currentAutorizationNumber) {
+        context->state = TLV_AUTHORIZATION_ACTOR;
+    } else {
         context->state++;
-        context->processingField = false;
-
-        os_memset(context->content->contract, 0, sizeof(context->content->contract));
-        name_to_string(context->contractName, context->content->contract, sizeof(context->content->contract));
     }
+    return true;
 }
 
 /**
- * Process Action Name Field. Cache a data of the field in order to 
- * display it for validation.
+ * Move to the next action or to the transaction tail.
+ * After the last action the manifest, if any, must match the actions.
 */
-static void processActionName(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
-
-        hashTxData(context, context->workBuffer, length);
-
-        uint8_t *pAction = (uint8_t *)&context->contractActionName;
-        os_memmove(pAction + context->currentFieldPos, context->workBuffer, length);
-
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
+static bool completeAction(txProcessingContext_t *context) {
+    uint8_t dataSize[4] = {
+        context->currentFieldLength, context->currentFieldLength >> 8,
+        context->currentFieldLength >> 16, context->currentFieldLength >> 24
+    };
+    context->actionsDigest = manifestFold(context->actionsDigest, dataSize, sizeof(dataSize));
+    if (++context->currentActionIndex < context->currentActionNumer) {
+        context->state = TLV_ACTION_ACCOUNT;
+    } else {
+        context->state = TLV_TX_EXTENSION_LIST_SIZE;
+        if (context->manifestActions != 0 && context->actionsDigest != context->manifestDigest) {
+            PRINTF("completeAction Manifest mismatch\n");
+            return false;
+        }
     }
+    context->actionReady = true;
+    return true;
+}
 
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->state++;
-        context->processingField = false;
-
-        os_memset(context->content->action, 0, sizeof(context->content->action));
-        name_to_string(context->contractActionName, context->content->action, sizeof(context->content->action));
-    }
+/**
+ * Unknown action data is not cached, only its checksum is displayed.
+*/
+static bool onUnknownActionData(txProcessingContext_t *context) {
+    processUnknownAction(context);
+    cx_sha256_init(context->dataSha256);
+    return completeAction(context);
 }
 
 /**
- * Process Authorization Number Field. Initializa context action number 
- * index and context action number. 
+ * Known action data has been decoded while it was arriving,
+ * the last page of arguments is ready for review.
 */
-static void processAuthorizationListSizeField(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
+static bool onActionData(txProcessingContext_t *context) {
+    if (!context->actionDecoded) {
+        PRINTF("onActionData Truncated action data\n");
+        return false;
+    }
+    setArgumentCount(context, context->argumentIndex.count);
 
-        hashTxData(context, context->workBuffer, length);
+    return completeAction(context);
+}
 
-        // Store data into a buffer
-        os_memmove(context->sizeBuffer + context->currentFieldPos, context->workBuffer, length);
+#define FIELD_HASH_TX   0x01
+#define FIELD_HASH_DATA 0x02
+#define FIELD_DECODE    0x04
 
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
-    }
+#define FIELD_CACHE(field) offsetof(txProcessingContext_t, field), sizeof(((txProcessingContext_t *)0)->field)
+#define FIELD_NO_CACHE 0, 0
 
-    if (context->currentFieldPos == context->currentFieldLength) {
-        unpack_variant32(context->sizeBuffer, context->currentFieldPos + 1, &context->currentAutorizationNumber);
-        context->currentAutorizationIndex = 0;
-        // Reset size buffer
-        os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
+// RAW encoding sizes besides fixed ones: varint, the value of the 
+// preceding varint field, or a name which RAW_NAMES may send as reference
+#define RAW_VARINT 0xFF
+#define RAW_SIZED  0xFE
+#define RAW_NAME   0xFD
 
-        // Move to next state
-        context->state++;
-        context->processingField = false;
-    }
-}
+/**
+ * Describes how a field value is consumed: its size in RAW encoding,
+ * which digests it feeds, where it is cached or whether it is decoded, 
+ * and what is done once it is complete.
+ * Fields without completion hook just move to the next state.
+ * Hooks return false if the completed field is invalid.
+*/
+typedef struct fieldDescriptor_t {
+    uint8_t flags;
+    uint8_t rawSize;
+    uint16_t cacheOffset;
+    uint16_t cacheSize;
+    bool (*onComplete)(txProcessingContext_t *context);
+} fieldDescriptor_t;
+
+static const fieldDescriptor_t fieldDescriptors[] = {
+    [TLV_CHAIN_ID]                   = { FIELD_HASH_TX, 32, FIELD_NO_CACHE, NULL },
+    [TLV_HEADER_EXPITATION]          = { FIELD_HASH_TX, 4, FIELD_NO_CACHE, NULL },
+    [TLV_HEADER_REF_BLOCK_NUM]       = { FIELD_HASH_TX, 2, FIELD_NO_CACHE, NULL },
+    [TLV_HEADER_REF_BLOCK_PREFIX]    = { FIELD_HASH_TX, 4, FIELD_NO_CACHE, NULL },
+    [TLV_HEADER_MAX_NET_USAGE_WORDS] = { FIELD_HASH_TX, RAW_VARINT, FIELD_NO_CACHE, NULL },
+    [TLV_HEADER_MAX_CPU_USAGE_MS]    = { FIELD_HASH_TX, 1, FIELD_NO_CACHE, NULL },
+    [TLV_HEADER_DELAY_SEC]           = { FIELD_HASH_TX, RAW_VARINT, FIELD_NO_CACHE, NULL },
+    [TLV_CFA_LIST_SIZE]              = { FIELD_HASH_TX, RAW_VARINT, FIELD_CACHE(sizeBuffer), onZeroSizeField },
+    [TLV_ACTION_LIST_SIZE]           = { FIELD_HASH_TX, RAW_VARINT, FIELD_CACHE(sizeBuffer), onActionListSize },
+    [TLV_ACTION_ACCOUNT]             = { FIELD_HASH_TX, RAW_NAME, FIELD_CACHE(contractName), onActionAccount },
+    [TLV_ACTION_NAME]                = { FIELD_HASH_TX, RAW_NAME, FIELD_CACHE(contractActionName), onActionName },
+    [TLV_AUTHORIZATION_LIST_SIZE]    = { FIELD_HASH_TX, RAW_VARINT, FIELD_CACHE(sizeBuffer), onAuthorizationListSize },
+    [TLV_AUTHORIZATION_ACTOR]        = { FIELD_HASH_TX, RAW_NAME, FIELD_NO_CACHE, NULL },
+    [TLV_AUTHORIZATION_PERMISSION]   = { FIELD_HASH_TX, RAW_NAME, FIELD_NO_CACHE, onAuthorizationPermission },
+    [TLV_ACTION_DATA_SIZE]           = { FIELD_HASH_TX, RAW_VARINT, FIELD_NO_CACHE, NULL },
+    [TLV_ACTION_DATA]                = { FIELD_HASH_TX | FIELD_DECODE, RAW_SIZED, FIELD_NO_CACHE, onActionData },
+    [TLV_TX_EXTENSION_LIST_SIZE]     = { FIELD_HASH_TX, RAW_VARINT, FIELD_CACHE(sizeBuffer), onZeroSizeField },
+    [TLV_CONTEXT_FREE_DATA]          = { FIELD_HASH_TX, sizeof(checksum256), FIELD_NO_CACHE, NULL },
+};
 
 /**
- * Process Authorization Permission Field. When the field is processed 
- * start over authorization processing if the there is data for that.
+ * Unknown actions are allowed only with contract data enabled. Their data
+ * size and data are not cached but hashed twice, to display a checksum.
 */
-static void processAuthorizationPermission(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
+static const fieldDescriptor_t unknownActionDataSizeDescriptor = {
+    FIELD_HASH_TX | FIELD_HASH_DATA, RAW_VARINT, FIELD_NO_CACHE, NULL
+};
 
-        hashTxData(context, context->workBuffer, length);
+static const fieldDescriptor_t unknownActionDataDescriptor = {
+    FIELD_HASH_TX | FIELD_HASH_DATA, RAW_SIZED, FIELD_NO_CACHE, onUnknownActionData
+};
 
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
+static const fieldDescriptor_t *getFieldDescriptor(txProcessingContext_t *context) {
+    if (context->state < TLV_CHAIN_ID || context->state > TLV_CONTEXT_FREE_DATA) {
+        return NULL;
     }
 
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->currentAutorizationIndex++;
-        // Reset size buffer
-        os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
-
-        // Start over reading Authorization data or move to the next state
-        // if all authorization data have beed read
-        if (context->currentAutorizationIndex != context->currentAutorizationNumber) {
-            context->state = TLV_AUTHORIZATION_ACTOR;
-        } else {
-            context->state++;
+    if (!context->knownAction && context->dataAllowed == 1) {
+        if (context->state == TLV_ACTION_DATA_SIZE) {
+            return (const fieldDescriptor_t *)PIC(&unknownActionDataSizeDescriptor);
         }
-        context->processingField = false;
+        if (context->state == TLV_ACTION_DATA) {
+            return (const fieldDescriptor_t *)PIC(&unknownActionDataDescriptor);
+        }
+    } else if (!context->knownAction && context->state == TLV_ACTION_DATA) {
+        PRINTF("UNKNOWN ACTION");
+        return NULL;
     }
-}
-
 
-static void processUnknownActionDataSize(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
-
-        hashTxData(context, context->workBuffer, length);
-        hashActionData(context, context->workBuffer, length);
+    return (const fieldDescriptor_t *)PIC(&fieldDescriptors[context->state]);
+}
 
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
+/**
+ * RAW encoding: a varint field ends at its first byte without continuation
+ * bit. Limit length to the bytes of the field and shrink the field length
+ * once the end is seen. The value is kept to size following action data.
+*/
+static bool scanRawVarint(txProcessingContext_t *context, uint32_t *length) {
+    uint32_t i;
+    for (i = 0; i < *length; ++i) {
+        uint8_t byte = context->workBuffer[i];
+        context->rawVarint |= (uint32_t)(byte & 0x7F) << (7 * (context->currentFieldPos + i));
+        if ((byte & 0x80) == 0) {
+            *length = i + 1;
+            context->currentFieldLength = context->currentFieldPos + *length;
+            return true;
+        }
     }
-
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->state++;
-        context->processingField = false;
+    if (context->currentFieldPos + *length == context->currentFieldLength) {
+        PRINTF("scanRawVarint Overflow\n");
+        return false;
     }
+    return true;
 }
 
-
 /**
- * Process current unknown action data field and calculate checksum.
+ * RAW encoding: start the next field with the size given by the schema.
 */
-static void processUnknownActionData(txProcessingContext_t *context) {
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
-
-        hashTxData(context, context->workBuffer, length);
-        hashActionData(context, context->workBuffer, length);
-
-        context->workBuffer += length;
-        context->commandLength -= length;
-        context->currentFieldPos += length;
+static void startRawField(txProcessingContext_t *context, const fieldDescriptor_t *descriptor) {
+    if (descriptor->rawSize == RAW_VARINT) {
+        // Upper bound, the field ends with the varint
+        context->currentFieldLength = sizeof(context->sizeBuffer);
+        context->rawVarint = 0;
+    } else if (descriptor->rawSize == RAW_SIZED) {
+        context->currentFieldLength = context->rawVarint;
+    } else if (descriptor->rawSize == RAW_NAME) {
+        // Expanded size, RAW_NAMES wire bytes are counted by namePos
+        context->currentFieldLength = sizeof(name_t);
+        context->namePos = 0;
+    } else {
+        context->currentFieldLength = descriptor->rawSize;
     }
+    context->currentFieldPos = 0;
+    context->processingField = true;
+}
 
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->currentActionDataBufferLength = context->currentFieldLength;
-
-        processUnknownAction(context);
-
-        if (++context->currentActionIndex < context->currentActionNumer) {
-            context->state = TLV_ACTION_ACCOUNT;
+/**
+ * RAW_NAMES: receive a name literal or dictionary reference into 
+ * nameBuffer. The name is complete when namePos reaches NAME_COMPLETE.
+*/
+#define NAME_COMPLETE (1 + sizeof(name_t))
+
+static bool receiveRawName(txProcessingContext_t *context) {
+    if (context->namePos == 0 && context->commandLength != 0) {
+        uint8_t tag;
+        readTxByte(context, &tag);
+        if (tag == NAME_LITERAL) {
+            context->namePos = 1;
+        } else if (tag < context->nameDictionaryCount) {
+            os_memmove(context->nameBuffer, &context->nameDictionary[tag], sizeof(name_t));
+            context->namePos = NAME_COMPLETE;
+            return true;
         } else {
-            context->state = TLV_TX_EXTENSION_LIST_SIZE;
+            PRINTF("receiveRawName Invalid reference\n");
+            return false;
         }
+    }
 
-        context->processingField = false;
-        context->actionReady = true;
-        
-        cx_sha256_init(context->dataSha256);
+    uint32_t length = NAME_COMPLETE - context->namePos;
+    if (length > context->commandLength) {
+        length = context->commandLength;
     }
+    os_memmove(context->nameBuffer + context->namePos - 1, context->workBuffer, length);
+    context->workBuffer += length;
+    context->commandLength -= length;
+    context->namePos += length;
+
+    if (context->namePos == NAME_COMPLETE) {
+        os_memmove(&context->nameDictionary[context->nameDictionaryNext], context->nameBuffer, sizeof(name_t));
+        context->nameDictionaryNext = (context->nameDictionaryNext + 1) % NAME_DICTIONARY_SIZE;
+        if (context->nameDictionaryCount < NAME_DICTIONARY_SIZE) {
+            context->nameDictionaryCount++;
+        }
+    }
+    return true;
 }
 
 /**
- * Process current action data field and store in into data buffer.
+ * Consume current field as described by its descriptor.
+ * The data comes in by chucks, so it may happen that buffer may contain 
+ * incomplete data for particular field. Function designed to process 
+ * everything until it receives all data for a particular field 
+ * and after that will move to next field.
+ * Returns false if the field is malformed.
 */
-static void processActionData(txProcessingContext_t *context) {
-    if (context->currentFieldLength > sizeof(context->actionDataBuffer) - 1) {
-        PRINTF("processActionData data overflow\n");
-        THROW(EXCEPTION);
+static bool processField(txProcessingContext_t *context, const fieldDescriptor_t *descriptor) {
+    if (context->currentFieldLength > descriptor->cacheSize && descriptor->cacheSize != 0) {
+        PRINTF("processField cache overflow\n");
+        return false;
     }
 
-    if (context->currentFieldPos < context->currentFieldLength) {
+    // Decoded fields are resumed even without new data, a pending 
+    // argument may be waiting for the previous page to be reviewed
+    if (context->currentFieldPos < context->currentFieldLength || (descriptor->flags & FIELD_DECODE)) {
         uint32_t length = 
             (context->commandLength <
                      ((context->currentFieldLength - context->currentFieldPos))
                 ? context->commandLength
                 : context->currentFieldLength - context->currentFieldPos);
 
-        hashTxData(context, context->workBuffer, length);
-        os_memmove(context->actionDataBuffer + context->currentFieldPos, context->workBuffer, length);
+        if (context->encoding != TX_ENCODING_TLV && descriptor->rawSize == RAW_VARINT &&
+            !scanRawVarint(context, &length)) {
+            return false;
+        }
+        if ((descriptor->flags & FIELD_DECODE) && !decodeActionData(context, context->workBuffer, &length)) {
+            return false;
+        }
+        if (descriptor->flags & FIELD_HASH_TX) {
+            hashTxData(context, context->workBuffer, length);
+        }
+        if (descriptor->flags & FIELD_HASH_DATA) {
+            hashActionData(context, context->workBuffer, length);
+        }
+        if (descriptor->cacheSize != 0) {
+            uint8_t *cache = (uint8_t *)context + descriptor->cacheOffset;
+            os_memmove(cache + context->currentFieldPos, context->workBuffer, length);
+        }
 
         context->workBuffer += length;
         context->commandLength -= length;
         context->currentFieldPos += length;
     }
 
+    if (context->actionPage && context->actionReady) {
+        return true;
+    }
+
     if (context->currentFieldPos == context->currentFieldLength) {
-        context->currentActionDataBufferLength = context->currentFieldLength;
-
-        if (context->contractActionName == EOSIO_TOKEN_TRANSFER) {
-            processTokenTransfer(context);
-        } else if (context->contractName == EOSIO) {
-            switch (context->contractActionName) {
-            case EOSIO_DELEGATEBW:
-                processEosioDelegate(context);
-                break;
-            case EOSIO_UNDELEGATEBW:
-                processEosioUndelegate(context);
-                break;
-            case EOSIO_REFUND:
-                processEosioRefund(context);
-                break;
-            case EOSIO_VOTEPRODUCER:
-                processEosioVoteProducer(context);
-                break;
-            case EOSIO_BUYRAM:
-            case EOSIO_BUYRAMBYTES:
-                processEosioBuyRam(context);
-                break;
-            case EOSIO_SELLRAM:
-                processEosioSellRam(context);
-                break;
-            case EOSIO_UPDATE_AUTH:
-                processEosioUpdateAuth(context);
-                break;
-            case EOSIO_DELETE_AUTH:
-                processEosioDeleteAuth(context);
-                break;
-            case EOSIO_LINK_AUTH:
-                processEosioLinkAuth(context);
-                break;
-            case EOSIO_UNLINK_AUTH:
-                processEosioUnlinkAuth(context);
-                break;
-            case EOSIO_NEW_ACCOUNT:
-                processEosioNewAccountAction(context);
-                break;
-            default:
-                THROW(EXCEPTION);
-            }
-        }
-        
-        if (++context->currentActionIndex < context->currentActionNumer) {
-            context->state = TLV_ACTION_ACCOUNT;
-        } else {
-            context->state = TLV_TX_EXTENSION_LIST_SIZE;
-        }
-        
         context->processingField = false;
-        context->actionReady = true;
+        if (descriptor->onComplete != NULL) {
+            return ((bool (*)(txProcessingContext_t *))PIC(descriptor->onComplete))(context);
+        }
+        context->state++;
     }
+    return true;
 }
 
 static parserStatus_e processTxInternal(txProcessingContext_t *context) {
@@ -758,26 +1011,72 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
             return STREAM_CONFIRM_PROCESSING;
         }
         if (context->actionReady) {
+            summaryStep_e step = summarizeAction(context);
+            if (step == ACTION_ENDS_RUN) {
+                // The action ending the run stays ready until the summary is reviewed
+                return STREAM_SUMMARY_READY;
+            }
             context->actionReady = false;
-            return STREAM_ACTION_READY;
+            if (step == ACTION_REVIEW) {
+                return STREAM_ACTION_READY;
+            }
+            if (context->currentActionIndex == context->currentActionNumer) {
+                // The last action ends the run
+                reportSummary(context);
+                return STREAM_SUMMARY_READY;
+            }
         }
         if (context->state == TLV_DONE) {
+            if (context->commandLength != 0) {
+                PRINTF("Trailing data after transaction\n");
+                return STREAM_FAULT;
+            }
+            // The caller finalizes the transaction digest
+            flushTxHash(context);
             return STREAM_FINISHED;
         }
         if (context->commandLength == 0) {
             return STREAM_PROCESSING;
         }
+        const fieldDescriptor_t *descriptor;
+        if (!context->processingField && context->encoding != TX_ENCODING_TLV) {
+            descriptor = getFieldDescriptor(context);
+            if (descriptor == NULL) {
+                PRINTF("Invalid RAW decoder context\n");
+                return STREAM_FAULT;
+            }
+            startRawField(context, descriptor);
+        }
         if (!context->processingField) {
             // While we are not processing a field, we should TLV parameters
             bool decoded = false;
-            while (context->commandLength != 0) {
+            uint32_t headerLength = 0;
+            if (context->tlvBufferPos == 0) {
+                // Fast path: the whole header is usually inside the current chunk,
+                // so decode it in place without staging it byte by byte
+                bool valid;
+                decoded = tlvTryDecode(context->workBuffer, context->commandLength,
+                    &context->currentFieldLength, &headerLength, &valid);
+
+                if (!valid) {
+                    PRINTF("TLV decoding error\n");
+                    return STREAM_FAULT;
+                }
+                if (decoded) {
+                    context->workBuffer += headerLength;
+                    context->commandLength -= headerLength;
+                }
+            }
+            // Slow path: header straddles chunks, feed it through the TLV buffer
+            while (!decoded && context->commandLength != 0) {
                 bool valid;
                 // Feed the TLV buffer until the length can be decoded
-                context->tlvBuffer[context->tlvBufferPos++] =
-                    readTxByte(context);
+                if (!readTxByte(context, &context->tlvBuffer[context->tlvBufferPos++])) {
+                    return STREAM_FAULT;
+                }
 
                 decoded = tlvTryDecode(context->tlvBuffer, context->tlvBufferPos, 
-                    &context->currentFieldLength, &valid);
+                    &context->currentFieldLength, &headerLength, &valid);
 
                 if (!valid) {
                     PRINTF("TLV decoding error\n");
@@ -797,78 +1096,41 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
             if (!decoded) {
                 return STREAM_PROCESSING;
             }
+            if (context->tlvBufferPos != 0) {
+                // The staged header shares its bytes with sizeBuffer
+                os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
+                context->tlvBufferPos = 0;
+            }
             context->currentFieldPos = 0;
-            context->tlvBufferPos = 0;
             context->processingField = true;
         }
-        switch (context->state) {
-        case TLV_CHAIN_ID:
-        case TLV_HEADER_EXPITATION:
-        case TLV_HEADER_REF_BLOCK_NUM:
-        case TLV_HEADER_REF_BLOCK_PREFIX:
-        case TLV_HEADER_MAX_CPU_USAGE_MS:
-        case TLV_HEADER_MAX_NET_USAGE_WORDS:
-        case TLV_HEADER_DELAY_SEC:
-            processField(context);
-            break;
-
-        case TLV_CFA_LIST_SIZE:
-            processZeroSizeField(context);
-            break;
-
-        case TLV_ACTION_LIST_SIZE:
-            processActionListSizeField(context);
-            break;
-
-        case TLV_ACTION_ACCOUNT:
-            processActionAccount(context);
-            break;
-
-        case TLV_ACTION_NAME:
-            processActionName(context);
-            break;
-
-        case TLV_AUTHORIZATION_LIST_SIZE:
-            processAuthorizationListSizeField(context);
-            break;
-
-        case TLV_AUTHORIZATION_ACTOR:
-            processField(context);
-            break;
-
-        case TLV_AUTHORIZATION_PERMISSION:
-            processAuthorizationPermission(context);
-            break;
-        
-        case TLV_ACTION_DATA_SIZE:
-            if (isKnownAction(context) || context->dataAllowed == 0) {
-                processField(context);
-            } else {
-                processUnknownActionDataSize(context);
+        descriptor = getFieldDescriptor(context);
+        if (descriptor == NULL) {
+            PRINTF("Invalid TLV decoder context\n");
+            return STREAM_FAULT;
+        }
+        if (context->encoding == TX_ENCODING_RAW_NAMES && descriptor->rawSize == RAW_NAME) {
+            if (!receiveRawName(context)) {
+                return STREAM_FAULT;
             }
-            break;
-        
-        case TLV_ACTION_DATA:
-            if (isKnownAction(context)) {
-                processActionData(context);
-            } else if (context->dataAllowed == 1) {
-                processUnknownActionData(context);
-            } else {
-                PRINTF("UNKNOWN ACTION");
-                THROW(EXCEPTION);
+            if (context->namePos != NAME_COMPLETE) {
+                continue;
             }
-            break;
-
-        case TLV_TX_EXTENSION_LIST_SIZE:
-            processZeroSizeField(context);
-            break;
-
-        case TLV_CONTEXT_FREE_DATA:
-            processField(context);
-            break;
-
-        default:
-            PRINTF("Invalid TLV decoder context\n");
+            // The field is processed from the expanded name, 
+            // so the digest sees the original bytes
+            uint8_t *workBuffer = context->workBuffer;
+            uint32_t commandLength = context->commandLength;
+            context->workBuffer = context->nameBuffer;
+            context->commandLength = sizeof(name_t);
+            bool processed = processField(context, descriptor);
+            context->workBuffer = workBuffer;
+            context->commandLength = commandLength;
+            if (!processed) {
+                return STREAM_FAULT;
+            }
+            continue;
+        }
+        if (!processField(context, descriptor)) {
             return STREAM_FAULT;
         }
     }
@@ -924,27 +1186,22 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
 */
 parserStatus_e parseTx(txProcessingContext_t *context, uint8_t *buffer, uint32_t length) {
     parserStatus_e result;
-#ifdef DEBUG_APP
-    // Do not catch exceptions.
-    context->workBuffer = buffer;
-    context->commandLength = length;
+    if (context->state == TLV_NONE) {
+        PRINTF("parseTx Context not initialized\n");
+        return STREAM_FAULT;
+    }
+    if (context->commandLength == 0) {
+        context->workBuffer = buffer;
+        context->commandLength = length;
+    }
     result = processTxInternal(context);
-#else
-    BEGIN_TRY {
-        TRY {
-            if (context->commandLength == 0) {
-                context->workBuffer = buffer;
-                context->commandLength = length;
-            }
-            result = processTxInternal(context);
-        }
-        CATCH_OTHER(e) {
-            result = STREAM_FAULT;
-        }
-        FINALLY {
-        }
+    if (result == STREAM_PROCESSING) {
+        // The chunk is answered, screens rendered from it are stale
+        dropScreens(context->content);
+    } else if (result == STREAM_FAULT) {
+        // The context is left mid-field, it must be initialized again
+        context->faultState = context->state;
+        context->state = TLV_NONE;
     }
-    END_TRY;
-#endif
     return result;
 }
@@ -23,12 +23,70 @@
 #include <stdbool.h>
 #include "eos_types.h"
 #include "eos_parse.h"
+#include "eos_decoder.h"
+#include "eos_parse_abi.h"
 
+// Previous and next argument
+#define PREFETCH_SCREENS 2
+#define SCREEN_NONE 0xFF
+
+typedef struct prefetchedScreen_t {
+    uint8_t argNum;
+    actionArgument_t arg;
+} prefetchedScreen_t;
+
+/**
+ * Summary mode, opted into for a transaction: consecutive actions with the
+ * same contract, action and sender that move a quantity to a recipient
+ * (token transfers) form a run while their recipients are in ascending
+ * name order, so every recipient of a run is a distinct account. The 
+ * first action of a run is reviewed in full, the following ones are only
+ * totalled per symbol and the run is reviewed as one summary once an 
+ * action ends it or the transaction has no more actions. Memos of the
+ * totalled actions are not shown.
+*/
+typedef enum txSummaryState_e {
+    SUMMARY_OFF,
+    // No run open, screens are prefetched
+    SUMMARY_IDLE,
+    // Run open, its summary takes the place of prefetched screens
+    SUMMARY_RUN,
+    // Summary screens are on review instead of action arguments
+    SUMMARY_REVIEW
+} txSummaryState_e;
+
+typedef struct txSummary_t {
+    // Argument count of the action ending the run, restored after review
+    uint8_t pendingCount;
+    uint8_t symbols;
+    uint16_t first;
+    uint16_t actions;
+    name_t contract;
+    name_t action;
+    name_t from;
+    name_t lastTo;
+    asset_t totals[SUMMARY_SYMBOLS];
+} txSummary_t;
+
+/**
+ * arg is the argument on screen, printedArgument its number. The
+ * arguments before and after it are rendered ahead into prefetched,
+ * a reviewed action never has more than these three formatted.
+ * Nothing is prefetched while a summary run is open.
+*/
 typedef struct txProcessingContent_t {
     char argumentCount;
     char contract[14];
     char action[14];
     actionArgument_t arg;
+    uint8_t printedArgument;
+    uint8_t summaryState;
+    union {
+        prefetchedScreen_t prefetched[PREFETCH_SCREENS];
+        txSummary_t summary;
+    };
+    // Keys shown so far in the transaction
+    publicKeyCache_t keys;
 } txProcessingContent_t;
 
 typedef enum txProcessingState_e {
@@ -54,31 +112,119 @@ typedef enum txProcessingState_e {
     TLV_DONE
 } txProcessingState_e;
 
+/**
+ * Wire format of the signing stream.
+ * TLV: every field is wrapped in a DER octet string (Transaction.encode2).
+ * RAW: plain EOS serialization, field boundaries come from the schema.
+ * RAW_NAMES: RAW where action and authorization names are sent either as
+ * NAME_LITERAL followed by the name, or as one byte index into the
+ * dictionary of the last NAME_DICTIONARY_SIZE literals (oldest replaced).
+ * All feed the same bytes to the digest.
+*/
+typedef enum txEncoding_e {
+    TX_ENCODING_TLV,
+    TX_ENCODING_RAW,
+    TX_ENCODING_RAW_NAMES
+} txEncoding_e;
+
+#define NAME_LITERAL 0xFF
+#define NAME_DICTIONARY_SIZE 8
+
+/**
+ * Pre-flight manifest: context free action count (must be 0), action 
+ * count, then for every action its account, name and data size as a 
+ * little endian uint32. It has to fit one APDU.
+*/
+#define MAX_MANIFEST_ACTIONS 12
+#define MANIFEST_ENTRY_SIZE (2 * sizeof(name_t) + sizeof(uint32_t))
+
+typedef struct txManifest_t {
+    uint8_t actions;
+    // FNV-1a of the action entries
+    uint32_t digest;
+} txManifest_t;
+
+#ifdef HAVE_HASH_STATS
+/**
+ * Digest update counters: hashUpdates is the number of transaction
+ * fragments, hashCalls the number of cx_hash calls they were batched into.
+*/
+typedef struct hashStats_t {
+    uint32_t hashUpdates;
+    uint32_t hashCalls;
+    uint32_t dataHashCalls;
+} hashStats_t;
+#endif
+
+/**
+ * All parsing state lives in the context and in the digests and content it
+ * points to, the parser has no globals. Contexts are independent, distinct
+ * transactions may be parsed concurrently.
+*/
 typedef struct txProcessingContext_t {
     txProcessingState_e state;
+    // State in which the last STREAM_FAULT occurred
+    txProcessingState_e faultState;
     bool actionReady;
     bool confirmProcessing;
+    bool processingField;
     cx_sha256_t *sha256;
     cx_sha256_t *dataSha256;
+    uint8_t hashBuffer[64];
+    uint8_t hashBufferLength;
+    // Actions announced by the manifest, 0 without manifest
+    uint8_t manifestActions;
+    uint8_t dataAllowed;
+    uint8_t encoding;
+    uint32_t manifestDigest;
+    // Same digest over the actions streamed so far
+    uint32_t actionsDigest;
     uint32_t currentFieldLength;
     uint32_t currentFieldPos;
     uint32_t currentAutorizationIndex;
     uint32_t currentAutorizationNumber;
     uint32_t currentActionIndex;
     uint32_t currentActionNumer;
-    uint32_t currentActionDataBufferLength;
-    bool processingField;
-    uint8_t tlvBuffer[5];
     uint32_t tlvBufferPos;
     uint8_t *workBuffer;
     uint32_t commandLength;
+    // RAW encoding: value of the last varint field, sizes action data
+    uint32_t rawVarint;
     name_t contractName;
     name_t contractActionName;
-    uint8_t sizeBuffer[12];
-    uint8_t actionDataBuffer[512];
-    uint8_t dataAllowed;
-    checksum256 dataChecksum;
+    bool knownAction;
+    // Registry entry of the known action
+    uint8_t registryIndex;
+    bool actionPage;
+    bool actionDecoded;
+    union {
+        // Header bytes straddling chunks, live until the header is decoded
+        uint8_t tlvBuffer[5];
+        // Size field value, live from its header to the end of the field
+        uint8_t sizeBuffer[5];
+        // RAW_NAMES: expanded name, live until the name field is processed
+        uint8_t nameBuffer[sizeof(name_t)];
+    };
+    // RAW_NAMES: wire bytes received for the current name
+    uint8_t namePos;
+    uint8_t nameDictionaryNext;
+    uint8_t nameDictionaryCount;
+    name_t nameDictionary[NAME_DICTIONARY_SIZE];
+    union {
+        // Known action: decoder state and decoded arguments
+        struct {
+            actionDecoder_t decoder;
+            argumentIndex_t argumentIndex;
+        };
+        // Unknown action: action data checksum
+        checksum256 dataChecksum;
+    };
     txProcessingContent_t *content;
+    // Uploaded action descriptors, NULL if there are none
+    const abiDescriptorStore_t *descriptors;
+#ifdef HAVE_HASH_STATS
+    hashStats_t hashStats;
+#endif
 } txProcessingContext_t;
 
 typedef enum parserStatus_e {
@@ -87,17 +233,77 @@ typedef enum parserStatus_e {
     STREAM_ACTION_READY,
     STREAM_CONFIRM_PROCESSING,
     STREAM_FINISHED,
+    // Summary mode: a run of actions is ready for review as one summary
+    STREAM_SUMMARY_READY,
 } parserStatus_e;
 
+/**
+ * Context with its own digests and content, for hosts that do not lay
+ * them out themselves as the device does in its RAM overlay.
+*/
+typedef struct txParser_t {
+    cx_sha256_t sha256;
+    cx_sha256_t dataSha256;
+    txProcessingContent_t content;
+    txProcessingContext_t context;
+} txParser_t;
+
 void initTxContext(
     txProcessingContext_t *context, 
     cx_sha256_t *sha256, 
     cx_sha256_t *dataSha256,
     txProcessingContent_t *processingContent,
-    uint8_t dataAllowed
+    uint8_t dataAllowed,
+    txEncoding_e encoding
 );
+void initTxParser(txParser_t *parser, uint8_t dataAllowed, txEncoding_e encoding);
+/**
+ * Signing session: hash a chain id known in advance, right after init,
+ * so the stream starts with the transaction header.
+*/
+void setTxChainId(txProcessingContext_t *context, const uint8_t *chainId);
+/**
+ * Validates a manifest before the transaction is streamed: actions must
+ * be known or allowed as contract data. The streamed transaction is 
+ * checked against it once set on a new context.
+*/
+bool checkTxManifest(const uint8_t *buffer, uint32_t length, uint8_t dataAllowed, 
+                     const abiDescriptorStore_t *descriptors, txManifest_t *manifest);
+void setTxManifest(txProcessingContext_t *context, const txManifest_t *manifest);
+/**
+ * Actions without a registry entry are looked up in the descriptor store,
+ * which must not change while the transaction is parsed.
+*/
+void setTxDescriptors(txProcessingContext_t *context, const abiDescriptorStore_t *descriptors);
+/**
+ * Summary mode is off on a new context, it may be turned on or off
+ * before the first action is ready.
+*/
+void setTxSummary(txProcessingContext_t *context, bool enabled);
+/**
+ * Descriptor of the action being decoded, NULL if it is not uploaded.
+*/
+const abiDescriptor_t *currentAbiDescriptor(const txProcessingContext_t *context);
+/**
+ * Errors are returned, never thrown: malformed input yields STREAM_FAULT
+ * and the context has to be initialized again.
+*/
 parserStatus_e parseTx(txProcessingContext_t *context, uint8_t *buffer, uint32_t length);
 
-void printArgument(uint8_t argNum, txProcessingContext_t *processingContext);
+/**
+ * Puts argument argNum in content->arg, taken from the prefetched
+ * screens when it is one of them. Once STREAM_SUMMARY_READY is returned
+ * arguments are the summary screens until the next action is ready.
+*/
+bool printArgument(uint8_t argNum, txProcessingContext_t *processingContext);
+/**
+ * Renders one missing neighbour of the printed argument, next first,
+ * or the first argument when none is printed yet. Only while a review is
+ * pending: arguments may refer to the chunk, which is gone once parseTx
+ * returns STREAM_PROCESSING and it is answered.
+ * Returns false once both are ready or rendering fails, failures are
+ * left for printArgument to report.
+*/
+bool prefetchArgument(txProcessingContext_t *processingContext);
 
 #endif // __EOS_STREAM_H__
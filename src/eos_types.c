@@ -24,20 +24,19 @@
 
 static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
 
-name_t buffer_to_name_type(uint8_t *in, uint32_t size) {
+bool buffer_to_name_type(uint8_t *in, uint32_t size, name_t *value) {
     if (size < 8) {
-        THROW(EXCEPTION_OVERFLOW);
+        return false;
     }
 
-    name_t value;
-    os_memmove(&value, in, 8);
+    os_memmove(value, in, 8);
 
-    return value;
+    return true;
 }
 
-uint8_t name_to_string(name_t value, char *out, uint32_t size) {
+bool name_to_string(name_t value, char *out, uint32_t size, uint32_t *written) {
     if (size < 13) {
-        THROW(EXCEPTION_OVERFLOW);
+        return false;
     }
 
     uint32_t i = 0;
@@ -56,7 +55,8 @@ uint8_t name_to_string(name_t value, char *out, uint32_t size) {
     }
 
     os_memmove(out, str, actual_size);
-    return actual_size;
+    *written = actual_size;
+    return true;
 }
 
 bool is_valid_symbol(symbol_t sym) {
@@ -91,11 +91,11 @@ uint64_t symbol_precision(symbol_t sym) {
     return sym & 0xff;
 }
 
-uint8_t symbol_to_string(symbol_t sym, char *out, uint32_t size) {
+static bool symbol_to_string(symbol_t sym, char *out, uint32_t size, uint32_t *written) {
     sym >>= 8;
 
     if (size < 8) {
-        THROW(EXCEPTION_OVERFLOW);
+        return false;
     }
 
     uint8_t i = 0;
@@ -109,48 +109,61 @@ uint8_t symbol_to_string(symbol_t sym, char *out, uint32_t size) {
     }
 
     os_memmove(out, tmp, i);
-    return i;
+    *written = i;
+    return true;
 }
 
-uint8_t asset_to_string(asset_t *asset, char *out, uint32_t size) {
+// EOS limits asset precision to 18
+#define ASSET_MAX_PRECISION 18
+
+bool asset_to_string(asset_t *asset, char *out, uint32_t size, uint32_t *written) {
     if (asset == NULL) {
-        THROW(INVALID_PARAMETER);
+        return false;
     }
 
-    int64_t p = (int64_t)symbol_precision(asset->symbol);
-    int64_t p10 = 1;
-    while (p > 0) {
-        p10 *= 10; --p;
+    uint32_t precision = (uint32_t)symbol_precision(asset->symbol);
+    if (precision > ASSET_MAX_PRECISION) {
+        return false;
+    }
+    char symbol[9];
+    uint32_t symbolLength;
+    os_memset(symbol, 0, sizeof(symbol));
+    if (!symbol_to_string(asset->symbol, symbol, 8, &symbolLength)) {
+        return false;
     }
 
-    p = (int64_t)symbol_precision(asset->symbol);
-
-    char fraction[p+1];
-    fraction[p] = 0;
-    int64_t change = asset->amount % p10;
+    uint64_t magnitude = (uint64_t)asset->amount;
+    uint32_t sign = 0;
+    if (asset->amount < 0) {
+        magnitude = -magnitude;
+        sign = 1;
+    }
+    // At least one integer digit, the fraction is zero padded
+    uint32_t digits = decimal_length(magnitude);
+    if (digits < precision + 1) {
+        digits = precision + 1;
+    }
+    uint32_t assetTextLength = sign + digits + (precision != 0 ? 1 : 0) + 1 + symbolLength;
+    if (assetTextLength > size) {
+        return false;
+    }
 
-    for (int64_t i = p - 1; i >= 0; --i) {
-        fraction[i] = (change % 10) + '0';
-        change /= 10;
+    char *p = out;
+    if (sign) {
+        *p++ = '-';
     }
-    char symbol[9];
-    os_memset(symbol, 0, sizeof(symbol));
-    symbol_to_string(asset->symbol, symbol, 8);
-
-    char tmp[64];
-    os_memset(tmp, 0, sizeof(tmp));
-    i64toa(asset->amount / p10, tmp);
-    uint32_t assetTextLength = strlen(tmp);
-    tmp[assetTextLength++] = '.';
-    os_memmove(tmp + assetTextLength, fraction, strlen(fraction));
-    assetTextLength = strlen(tmp);
-    tmp[assetTextLength++] = ' ';
-    os_memmove(tmp + assetTextLength, symbol, strlen(symbol));
-    assetTextLength = strlen(tmp);
-    
-    os_memmove(out, tmp, assetTextLength);
+    format_decimal(magnitude, precision + 1, p);
+    p += digits - precision;
+    if (precision != 0) {
+        os_memmove(p + 1, p, precision);
+        *p = '.';
+        p += precision + 1;
+    }
+    *p++ = ' ';
+    os_memmove(p, symbol, symbolLength);
+    *written = assetTextLength;
 
-    return assetTextLength;
+    return true;
 }
 
 uint32_t unpack_variant32(uint8_t *in, uint32_t length, variant32_t *value) {
@@ -166,27 +179,27 @@ uint32_t unpack_variant32(uint8_t *in, uint32_t length, variant32_t *value) {
     return i;
 }
 
-uint32_t public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength) {
+bool public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength, uint32_t *written) {
     if (publicKey == NULL || keyLength < 33) {
-        THROW(INVALID_PARAMETER);
+        return false;
     }
     if (outLength < 40) {
-        THROW(EXCEPTION_OVERFLOW);
+        return false;
     }
 
     uint8_t temp[33];
     // is even?
     temp[0] = (publicKey[64] & 0x1) ? 0x03 : 0x02;
     os_memmove(temp + 1, publicKey + 1, 32);
-    return compressed_public_key_to_wif(temp, sizeof(temp), out, outLength);
+    return compressed_public_key_to_wif(temp, sizeof(temp), out, outLength, written);
 }
 
-uint32_t compressed_public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength) {
+bool compressed_public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength, uint32_t *written) {
     if (keyLength < 33) {
-        THROW(INVALID_PARAMETER);
+        return false;
     }
     if (outLength < 40) {
-        THROW(EXCEPTION_OVERFLOW);
+        return false;
     }
     
     uint8_t temp[37];
@@ -204,9 +217,42 @@ uint32_t compressed_public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, ch
     out[1] = 'O';
     out[2] = 'S';
     uint32_t addressLen = outLength - 3;
-    b58enc(temp, sizeof(temp), out + 3, &addressLen);
+    if (!b58enc(temp, sizeof(temp), out + 3, &addressLen)) {
+        return false;
+    }
     if (addressLen + 3 >= outLength) {
-        THROW(EXCEPTION_OVERFLOW);
+        return false;
+    }
+    *written = addressLen + 3;
+    return true;
+}
+
+void reset_public_key_cache(publicKeyCache_t *cache) {
+    os_memset(cache, 0, sizeof(publicKeyCache_t));
+}
+
+bool cached_public_key_to_wif(publicKeyCache_t *cache, uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength, uint32_t *written) {
+    uint8_t i;
+    if (cache == NULL || keyLength < sizeof(public_key_t) || outLength <= PUBLIC_KEY_WIF_LENGTH) {
+        return compressed_public_key_to_wif(publicKey, keyLength, out, outLength, written);
     }
-    return addressLen + 3;
+
+    for (i = 0; i < PUBLIC_KEY_CACHE_SIZE; ++i) {
+        if (cache->wif[i][0] != 0 && os_memcmp(cache->keys[i], publicKey, sizeof(public_key_t)) == 0) {
+            os_memset(out, 0, outLength);
+            os_memmove(out, cache->wif[i], PUBLIC_KEY_WIF_LENGTH);
+            *written = PUBLIC_KEY_WIF_LENGTH;
+            return true;
+        }
+    }
+
+    if (!compressed_public_key_to_wif(publicKey, keyLength, out, outLength, written)) {
+        return false;
+    }
+    if (*written == PUBLIC_KEY_WIF_LENGTH) {
+        os_memmove(cache->keys[cache->next], publicKey, sizeof(public_key_t));
+        os_memmove(cache->wif[cache->next], out, PUBLIC_KEY_WIF_LENGTH);
+        cache->next = (cache->next + 1) % PUBLIC_KEY_CACHE_SIZE;
+    }
+    return true;
 }
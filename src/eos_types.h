@@ -19,6 +19,8 @@
 #define __EOS_TYPES_H__
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "eos_profile.h"
 
 typedef uint32_t variant32_t;
 typedef uint64_t name_t;
@@ -54,12 +56,36 @@ typedef struct asset_t {
 
 uint32_t unpack_variant32(uint8_t *in, uint32_t length, variant32_t *value);
 
-name_t buffer_to_name_type(uint8_t *in, uint32_t size);
-uint8_t name_to_string(name_t value, char *out, uint32_t size);
+/**
+ * Conversions report failure (short input or output buffer) by returning
+ * false, they never throw. Written length is set on success only.
+*/
+bool buffer_to_name_type(uint8_t *in, uint32_t size, name_t *value);
+bool name_to_string(name_t value, char *out, uint32_t size, uint32_t *written);
 
-uint8_t asset_to_string(asset_t *asset, char *out, uint32_t size);
+bool asset_to_string(asset_t *asset, char *out, uint32_t size, uint32_t *written);
 
-uint32_t public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength);
-uint32_t compressed_public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength);
+bool public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength, uint32_t *written);
+bool compressed_public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength, uint32_t *written);
+
+// "EOS" and the base58 encoding of a compressed key with its checksum
+#define PUBLIC_KEY_WIF_LENGTH 53
+
+/**
+ * Keys encoded during one transaction, oldest replaced. An entry is
+ * free while its wif is empty.
+*/
+typedef struct publicKeyCache_t {
+    public_key_t keys[PUBLIC_KEY_CACHE_SIZE];
+    char wif[PUBLIC_KEY_CACHE_SIZE][PUBLIC_KEY_WIF_LENGTH];
+    uint8_t next;
+} publicKeyCache_t;
+
+void reset_public_key_cache(publicKeyCache_t *cache);
+/**
+ * compressed_public_key_to_wif, reusing the encoding of a key already in
+ * cache. A NULL cache encodes every time.
+*/
+bool cached_public_key_to_wif(publicKeyCache_t *cache, uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength, uint32_t *written);
 
 #endif // __EOS_TYPES_H__
@@ -26,47 +26,83 @@ unsigned char const BASE58ALPHABET[] = {
     'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'm',
     'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
 
+/**
+ * The number is converted to limbs of four base58 digits, a byte at a
+ * time: a limb shifted by 8 bits still fits 32 bits (58^4 * 256 < 2^32).
+ * Divisions by 58^4 and 58 are multiplications by a reciprocal and shifts,
+ * exact over the ranges used, as the target has no divide instruction.
+*/
+#define B58_LIMB 11316496 // 58^4 = 16 * 29^4
+#define B58_LIMB_DIGITS 4
+#define B58_MAX_INPUT 40
+#define B58_MAX_LIMBS ((B58_MAX_INPUT * 138 / 100 + 1 + B58_LIMB_DIGITS - 1) / B58_LIMB_DIGITS)
+
+// x / 58^4 for any 32 bit x: (x / 16) / 29^4, 2^48 / 29^4 rounded up
+static uint32_t b58_limb_div(uint32_t x)
+{
+	return (uint32_t)(((uint64_t)(x >> 4) * 397967678ull) >> 48);
+}
+
+// x / 58 for x below 58^4 < 2^24, 2^30 / 58 rounded up
+static uint32_t b58_digit_div(uint32_t x)
+{
+	return (uint32_t)(((uint64_t)x * 18512791ull) >> 30);
+}
+
 bool b58enc(uint8_t *bin, uint32_t binsz, char *b58, uint32_t *b58sz)
 {
-	int carry;
-	uint32_t i, j, high, zcount = 0;
-	uint32_t size;
+	// Least significant limb first
+	uint32_t limbs[B58_MAX_LIMBS];
+	uint32_t used = 0;
+	uint32_t i, j, size, limb, quotient, carry, zcount = 0;
+	char *p;
+	
+	if (binsz > B58_MAX_INPUT)
+		return false;
 	
 	while (zcount < binsz && !bin[zcount])
 		++zcount;
 	
-	size = (binsz - zcount) * 138 / 100 + 1;
-	uint8_t buf[size];
-	os_memset(buf, 0, size);
-	
-	for (i = zcount, high = size - 1; i < binsz; ++i, high = j)
+	for (i = zcount; i < binsz; ++i)
 	{
-		for (carry = bin[i], j = size - 1; (j > high) || carry; --j)
+		for (carry = bin[i], j = 0; j < used; ++j)
+		{
+			carry += limbs[j] << 8;
+			quotient = b58_limb_div(carry);
+			limbs[j] = carry - quotient * B58_LIMB;
+			carry = quotient;
+		}
+		for (; carry; carry = quotient)
 		{
-			carry += 256 * buf[j];
-			buf[j] = carry % 58;
-			carry /= 58;
-			if (!j) {
-				// Otherwise j wraps to maxint which is > high
-				break;
-			}
+			quotient = b58_limb_div(carry);
+			limbs[used++] = carry - quotient * B58_LIMB;
 		}
 	}
 	
-	for (j = 0; j < size && !buf[j]; ++j);
+	size = used ? (used - 1) * B58_LIMB_DIGITS : 0;
+	for (limb = used ? limbs[used - 1] : 0; limb; limb = b58_digit_div(limb))
+		++size;
 	
-	if (*b58sz <= zcount + size - j)
+	if (*b58sz <= zcount + size)
 	{
-		*b58sz = zcount + size - j + 1;
+		*b58sz = zcount + size + 1;
 		return false;
 	}
 	
 	if (zcount)
 		os_memset(b58, '1', zcount);
-	for (i = zcount; j < size; ++i, ++j)
-		b58[i] = BASE58ALPHABET[buf[j]];
-	b58[i] = '\0';
-	*b58sz = i + 1;
+	p = b58 + zcount + size;
+	*p = '\0';
+	for (j = 0; j < used; ++j)
+	{
+		// Leading zeros of the top limb fall outside the number
+		for (limb = limbs[j], i = 0; i < B58_LIMB_DIGITS && p > b58 + zcount; ++i, limb = quotient)
+		{
+			quotient = b58_digit_div(limb);
+			*--p = BASE58ALPHABET[limb - quotient * 58];
+		}
+	}
+	*b58sz = zcount + size + 1;
 	
 	return true;
 }
@@ -78,46 +114,110 @@ void array_hexstr(char *strbuf, const void *bin, unsigned int len) {
     while (len--) {
         *strbuf++ = hex_digits[((*((char *)bin)) >> 4) & 0xF];
         *strbuf++ = hex_digits[(*((char *)bin)) & 0xF];
-        bin = (const void *)((unsigned int)bin + 1);
+        bin = (const void *)((const uint8_t *)bin + 1);
     }
     *strbuf = 0; // EOS
 }
 
-char const digit[] = "0123456789";
+static const uint64_t POWERS_OF_TEN[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+    100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull};
+
+#define POWERS_OF_TEN_COUNT (sizeof(POWERS_OF_TEN) / sizeof(POWERS_OF_TEN[0]))
+
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+uint32_t decimal_length(uint64_t value) {
+    uint32_t length = 1;
+    while (length < POWERS_OF_TEN_COUNT && value >= POWERS_OF_TEN[length]) {
+        ++length;
+    }
+    return length;
+}
+
+uint32_t format_decimal(uint64_t value, uint32_t width, char *out) {
+    uint32_t length = decimal_length(value);
+    uint32_t i;
+    uint32_t low;
+    char *p;
+
+    if (length < width) {
+        length = width;
+    }
+    out[length] = '\0';
+    // Leading digits by subtracting powers of ten, until the rest fits 32 bits
+    for (i = 0; length - i > 9; ++i) {
+        uint32_t position = length - i - 1;
+        char digit = '0';
+        if (position < POWERS_OF_TEN_COUNT) {
+            while (value >= POWERS_OF_TEN[position]) {
+                value -= POWERS_OF_TEN[position];
+                ++digit;
+            }
+        }
+        out[i] = digit;
+    }
+    // Then two digits per step from the end, x / 100 is (x * 0x51EB851F) >> 37
+    low = (uint32_t)value;
+    p = out + length;
+    while (p - (out + i) > 1) {
+        uint32_t quotient = (uint32_t)(((uint64_t)low * 0x51EB851F) >> 37);
+        uint32_t pair = 2 * (low - quotient * 100);
+        *--p = DIGIT_PAIRS[pair + 1];
+        *--p = DIGIT_PAIRS[pair];
+        low = quotient;
+    }
+    if (p != out + i) {
+        *--p = '0' + low;
+    }
+    return length;
+}
+
 char* i64toa(int64_t i, char b[]) {
+    uint64_t magnitude = (uint64_t)i;
     char* p = b;
     if(i<0){
         *p++ = '-';
-        i *= -1;
+        magnitude = -magnitude;
     }
-    int64_t shifter = i;
-    do{ //Move to where representation ends
-        ++p;
-        shifter = shifter/10;
-    }while(shifter);
-    *p = '\0';
-    do{ //Move back, inserting digits as u go
-        *--p = digit[i%10];
-        i = i/10;
-    }while(i);
+    format_decimal(magnitude, 1, p);
     return b;
 }
 
 char* ui64toa(uint64_t i, char b[]) {
-    char* p = b;
-    uint64_t shifter = i;
-    do{ //Move to where representation ends
-        ++p;
-        shifter = shifter/10;
-    }while(shifter);
-    *p = '\0';
-    do{ //Move back, inserting digits as u go
-        *--p = digit[i%10];
-        i = i/10;
-    }while(i);
+    format_decimal(i, 1, b);
     return b;
 }
 
+uint32_t format_label(char *out, uint32_t size, const char *format, uint32_t first, uint32_t second) {
+    char number[11];
+    uint32_t length = 0;
+    uint32_t numbers = 0;
+    uint32_t i;
+
+    if (size == 0) {
+        return 0;
+    }
+    while (*format != 0 && length + 1 < size) {
+        if (format[0] == '%' && format[1] == 'd') {
+            format_decimal(numbers++ == 0 ? first : second, 1, number);
+            for (i = 0; number[i] != 0 && length + 1 < size; ++i) {
+                out[length++] = number[i];
+            }
+            format += 2;
+        } else {
+            out[length++] = *format++;
+        }
+    }
+    out[length] = '\0';
+    return length;
+}
+
 /**
  * Decodes tag according to ASN1 standard.
 */
@@ -138,8 +238,10 @@ static void decodeTag(uint8_t byte, uint8_t *cls, uint8_t *type, uint8_t *nr) {
 /**
  * tlv buffer is 5 bytes long. First byte is used for tag.
  * Next, up to four bytes could be used to to encode length.
+ * When decoded, headerLength receives the number of bytes taken by tag and length,
+ * so the header can be decoded in place and skipped in one step.
 */
-bool tlvTryDecode(uint8_t *buffer, uint32_t bufferLength, uint32_t *fieldLenght, bool *valid) {
+bool tlvTryDecode(uint8_t *buffer, uint32_t bufferLength, uint32_t *fieldLenght, uint32_t *headerLength, bool *valid) {
     uint8_t class, type, number;
     decodeTag(*buffer, &class, &type, &number);
     
@@ -179,8 +281,10 @@ bool tlvTryDecode(uint8_t *buffer, uint32_t bufferLength, uint32_t *fieldLenght,
         for (i = 0; i < count; ++i) {
             length = (length << 8) | *(buffer + i);
         }
+        *headerLength = 2 + count;
     } else {
         length = byte;
+        *headerLength = 2;
     }
     *fieldLenght = length;
     *valid = true;
@@ -25,12 +25,29 @@ bool b58enc(uint8_t *data, uint32_t binsz, char *b58, uint32_t *b58sz);
 
 void array_hexstr(char *strbuf, const void *bin, unsigned int len);
 
+/**
+ * Decimal formatting without divisions, a library call on Cortex-M0:
+ * digits above 10^9 are counted by subtracting a power of ten table, the
+ * rest are taken two at a time. format_decimal writes at least width
+ * digits, zero padded, and a terminating zero, and returns the digit count.
+*/
+uint32_t decimal_length(uint64_t value);
+uint32_t format_decimal(uint64_t value, uint32_t width, char *out);
+
 char* i64toa(int64_t i, char b[]);
 char* ui64toa(uint64_t i, char b[]);
 
+/**
+ * Label composer in place of snprintf: every %d of format takes first,
+ * then second. Other characters are copied as is. Output is truncated to
+ * size with a terminating zero, its length is returned.
+*/
+uint32_t format_label(char *out, uint32_t size, const char *format, uint32_t first, uint32_t second);
+
 bool tlvTryDecode(uint8_t *buffer,
                   uint32_t bufferLength,
                   uint32_t *fieldLenght,
+                  uint32_t *headerLength,
                   bool *valid);
 
 unsigned char check_canonical(uint8_t *rs);
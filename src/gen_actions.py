@@ -0,0 +1,343 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+Generates the action registry included by eos_stream.c from
+eos_actions.spec: names are encoded here and entries are sorted by
+(contract, action), so the device looks actions up by binary search.
+
+Actions whose decoder is abi:<file> are compiled from the contract ABI
+into the bytecode run by decodeAbi, written to eos_abi.h together with
+the labels and parsers of their fields (see eos_parse_abi.h).
+
+With --descriptor, an action is compiled into the descriptor the host
+uploads with INS_ABI_DESCRIPTOR instead, printed hex encoded.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+
+# Contract * is stored as 0, no account has an empty name
+ANY_CONTRACT = '*'
+ABI_PREFIX = 'abi:'
+
+# Instructions are emitted by name, eos_parse_abi.h defines them
+ABI_OP_END = 'ABI_OP_END'
+ABI_OP_FIXED = 'ABI_OP_FIXED'
+ABI_OP_STRING = 'ABI_OP_STRING'
+ABI_OP_VARUINT32 = 'ABI_OP_VARUINT32'
+ABI_OP_SKIP = 'ABI_OP_SKIP'
+ABI_OP_VECTOR = 'ABI_OP_VECTOR'
+ABI_OP_LOOP = 'ABI_OP_LOOP'
+
+OPCODES = {
+    ABI_OP_END: 0x00,
+    ABI_OP_FIXED: 0x01,
+    ABI_OP_STRING: 0x02,
+    ABI_OP_VARUINT32: 0x03,
+    ABI_OP_SKIP: 0x04,
+    ABI_OP_VECTOR: 0x05,
+    ABI_OP_LOOP: 0x06,
+}
+
+# Descriptor field types, abiFieldType_e
+PARSER_TYPES = {
+    'parseNameField': 0,
+    'parseAssetField': 1,
+    'parseStringField': 2,
+    'parseUint16Field': 3,
+    'parseUint32Field': 4,
+    'parseUInt64Field': 5,
+    'parsePublicKeyField': 6,
+    'parsePermissionField': 7,
+}
+
+# See ABI_DESCRIPTOR_* and FIELD_DESCRIPTOR in eos_parse_abi.h
+DESCRIPTOR_SLOTS = 4
+DESCRIPTOR_FIELDS = 8
+DESCRIPTOR_LABEL_SIZE = 20
+DESCRIPTOR_PROGRAM_SIZE = 64
+FIELD_DESCRIPTOR = 0xF0
+
+# ABI types with a fixed size: size, parser
+FIXED_TYPES = {
+    'name': (8, 'parseNameField'),
+    'account_name': (8, 'parseNameField'),
+    'permission_name': (8, 'parseNameField'),
+    'action_name': (8, 'parseNameField'),
+    'asset': (16, 'parseAssetField'),
+    'uint16': (2, 'parseUint16Field'),
+    'uint32': (4, 'parseUint32Field'),
+    'uint64': (8, 'parseUInt64Field'),
+    # Rendered as actor@permission
+    'permission_level': (16, 'parsePermissionField'),
+}
+
+# Room for the ordinal of fields inside a vector, up to 3 digits
+ORDINAL_WIDTH = 3
+# actionArgument_t label without the terminating zero
+LABEL_SIZE = 31
+MAX_FIELDS = 192
+
+
+def code_size(code):
+    return sum(len(instruction) for instruction in code)
+
+
+class AbiCompiler:
+    """Compiles action structs into one bytecode blob and field table.
+    Code is a list of instructions, each a list of its bytes."""
+
+    # Label format of fields inside a vector
+    VECTOR_LABEL = ' #%d'
+
+    def __init__(self):
+        self.program = []
+        self.comments = []
+        self.fields = []
+        self.programs = {}
+        self.abis = {}
+
+    def load(self, path):
+        if path not in self.abis:
+            with open(path) as f:
+                abi = json.load(f)
+            self.abis[path] = (
+                dict((t['new_type_name'], t['type']) for t in abi.get('types', [])),
+                dict((s['name'], s) for s in abi.get('structs', [])),
+                dict((a['name'], a['type']) for a in abi.get('actions', [])),
+            )
+        return self.abis[path]
+
+    def field(self, label, parser):
+        if len(label.replace('%d', '9' * ORDINAL_WIDTH)) > LABEL_SIZE:
+            raise ValueError("Label too long: " + label)
+        entry = (label, parser)
+        if entry not in self.fields:
+            if len(self.fields) == MAX_FIELDS:
+                raise ValueError("Too many ABI fields")
+            self.fields.append(entry)
+        return 'FIELD_ABI + %d' % self.fields.index(entry)
+
+    def compile_type(self, abi, type_name, label, in_vector, code):
+        (types, structs, _) = abi
+        while type_name in types:
+            type_name = types[type_name]
+        if type_name.endswith('[]'):
+            if in_vector:
+                raise ValueError("Nested vector in " + label)
+            body = []
+            self.compile_type(abi, type_name[:-2], label + self.VECTOR_LABEL, True, body)
+            length = code_size(body)
+            if length > 0xFF:
+                raise ValueError("Vector body too long in " + label)
+            code += [[ABI_OP_VECTOR, length]] + body + [[ABI_OP_LOOP, length]]
+        elif type_name in FIXED_TYPES:
+            (size, parser) = FIXED_TYPES[type_name]
+            code.append([ABI_OP_FIXED, size, self.field(label, parser)])
+        elif type_name == 'string':
+            code.append([ABI_OP_STRING, self.field(label, 'parseStringField')])
+        elif type_name == 'varuint32':
+            code.append([ABI_OP_VARUINT32, self.field(label, 'parseUint32Field')])
+        elif type_name == 'public_key':
+            # Key type is not displayed
+            code += [[ABI_OP_SKIP, 1], [ABI_OP_FIXED, 33, self.field(label, 'parsePublicKeyField')]]
+        elif type_name in structs:
+            self.compile_struct(abi, type_name, label, in_vector, code)
+        else:
+            raise ValueError("Unsupported type %s of %s" % (type_name, label))
+
+    def compile_struct(self, abi, struct_name, prefix, in_vector, code):
+        (_, structs, _) = abi
+        struct = structs[struct_name]
+        if struct.get('base'):
+            self.compile_struct(abi, struct['base'], prefix, in_vector, code)
+        for field in struct['fields']:
+            name = field['name'].replace('_', ' ')
+            label = prefix + ' ' + name if prefix else name[0].upper() + name[1:]
+            self.compile_type(abi, field['type'], label, in_vector, code)
+
+    def compile_action(self, path, contract, action):
+        abi = self.load(path)
+        if action not in abi[2]:
+            raise ValueError("%s does not define action %s" % (path, action))
+        code = []
+        self.compile_struct(abi, abi[2][action], '', False, code)
+        code.append([ABI_OP_END])
+        key = repr(code)
+        if key not in self.programs:
+            self.programs[key] = code_size(self.program)
+            self.comments.append((len(self.program), '%s::%s' % (contract, action)))
+            self.program += code
+            if code_size(self.program) > 0xFFFF:
+                raise ValueError("ABI bytecode too long")
+        return self.programs[key]
+
+    def write(self, path):
+        lines = [
+            '/**',
+            ' * Generated by gen_actions.py from eos_actions.spec, do not edit.',
+            ' * Bytecode of ABI described actions and the fields they display.',
+            '*/',
+            '',
+            'static const argumentField_t abiFields[] = {',
+        ]
+        for (label, parser) in self.fields:
+            lines.append('    { "%s", %s },' % (label, parser))
+        if not self.fields:
+            lines.append('    { "", parseNameField },')
+        lines += ['};', '', 'static const uint8_t abiProgram[] = {']
+        starts = dict(self.comments)
+        for (number, instruction) in enumerate(self.program or [[ABI_OP_END]]):
+            if number in starts:
+                lines.append('    // %s, offset %d' % (starts[number], code_size(self.program[:number])))
+            lines.append('    %s,' % ', '.join(str(value) for value in instruction))
+        lines.append('};')
+        with open(path, 'w') as f:
+            f.write('\n'.join(lines) + '\n')
+
+
+def char_to_symbol(c):
+    if 'a' <= c <= 'z':
+        return ord(c) - ord('a') + 6
+    if '1' <= c <= '5':
+        return ord(c) - ord('1') + 1
+    return 0
+
+
+def name_to_number(name):
+    if not re.match(r'^[a-z1-5.]{1,12}$', name):
+        raise ValueError("Invalid name " + name)
+    value = 0
+    for i in range(13):
+        c = char_to_symbol(name[i]) if i < len(name) else 0
+        if i < 12:
+            value |= (c & 0x1f) << (64 - 5 * (i + 1))
+        else:
+            value |= c & 0x0f
+    return value
+
+
+class DescriptorCompiler(AbiCompiler):
+    """Compiles one action into an uploadable descriptor, its fields are
+    local and the device numbers vector elements itself."""
+
+    VECTOR_LABEL = ''
+
+    def field(self, label, parser):
+        if len(label) >= DESCRIPTOR_LABEL_SIZE:
+            raise ValueError("Label too long: " + label)
+        entry = (label, parser)
+        if entry not in self.fields:
+            if len(self.fields) == DESCRIPTOR_FIELDS:
+                raise ValueError("Too many descriptor fields")
+            self.fields.append(entry)
+        return FIELD_DESCRIPTOR + self.fields.index(entry)
+
+    def descriptor(self, path, contract, action):
+        self.compile_action(path, contract, action)
+        program = bytes(OPCODES.get(value, value) for instruction in self.program for value in instruction)
+        if len(program) > DESCRIPTOR_PROGRAM_SIZE:
+            raise ValueError("Descriptor program too long")
+        data = name_to_number(contract).to_bytes(8, 'little')
+        data += name_to_number(action).to_bytes(8, 'little')
+        data += bytes([len(self.fields)])
+        for i in range(DESCRIPTOR_FIELDS):
+            (label, parser) = self.fields[i] if i < len(self.fields) else ('', 'parseNameField')
+            data += bytes([PARSER_TYPES[parser]]) + label.encode().ljust(DESCRIPTOR_LABEL_SIZE, b'\0')
+        return data + program.ljust(DESCRIPTOR_PROGRAM_SIZE, b'\0')
+
+
+def descriptor(path, contract, action):
+    return DescriptorCompiler().descriptor(path, contract, action)
+
+
+def read_spec(path, compiler):
+    entries = []
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if len(fields) != 3:
+                raise ValueError("%s:%d: expected contract, action and decoder" % (path, number))
+            (contract, action, decoder) = fields
+            contract_value = 0 if contract == ANY_CONTRACT else name_to_number(contract)
+            program = 0
+            if decoder.startswith(ABI_PREFIX):
+                abi = os.path.join(os.path.dirname(path), decoder[len(ABI_PREFIX):])
+                program = compiler.compile_action(abi, contract, action)
+                decoder = 'decodeAbi'
+            entries.append((contract_value, name_to_number(action), decoder, program, contract, action))
+    entries.sort()
+    for (previous, entry) in zip(entries, entries[1:]):
+        if previous[:2] == entry[:2]:
+            raise ValueError("%s: %s::%s is listed twice" % (path, entry[4], entry[5]))
+    return entries
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('spec', nargs='?', default=os.path.join(ROOT, 'eos_actions.spec'))
+    parser.add_argument('output', nargs='?', default=os.path.join(ROOT, 'eos_actions.h'))
+    parser.add_argument('abi_output', nargs='?', default=os.path.join(ROOT, 'eos_abi.h'))
+    parser.add_argument('--descriptor', nargs=3, metavar=('ABI', 'CONTRACT', 'ACTION'),
+                        help="Print the descriptor of an action instead")
+    args = parser.parse_args()
+
+    if args.descriptor:
+        print(descriptor(*args.descriptor).hex())
+        return
+
+    compiler = AbiCompiler()
+    entries = read_spec(args.spec, compiler)
+    if len(entries) + DESCRIPTOR_SLOTS >= 0xFF:
+        raise ValueError("Registry indexes are uint8_t, descriptor slots and ACTION_UNKNOWN excluded")
+
+    lines = [
+        '/**',
+        ' * Generated by gen_actions.py from eos_actions.spec, do not edit.',
+        ' * Sorted by contract, then action.',
+        '*/',
+        '',
+        '#define ACTION_REGISTRY_SIZE %d' % len(entries),
+        '',
+        'static const actionEntry_t actionRegistry[ACTION_REGISTRY_SIZE] = {',
+    ]
+    for (contract_value, action_value, decoder, program, contract, action) in entries:
+        lines.append('    { 0x%016X, 0x%016X, %s, %d }, // %s::%s' %
+                     (contract_value, action_value, decoder, program, contract, action))
+    lines.append('};')
+
+    with open(args.output, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+    compiler.write(args.abi_output)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except ValueError as e:
+        sys.stderr.write(str(e) + '\n')
+        sys.exit(1)
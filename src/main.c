@@ -33,11 +33,14 @@ unsigned int io_seproxyhal_touch_tx_ok(const bagl_element_t *e);
 unsigned int io_seproxyhal_touch_tx_cancel(const bagl_element_t *e);
 unsigned int io_seproxyhal_touch_address_ok(const bagl_element_t *e);
 unsigned int io_seproxyhal_touch_address_cancel(const bagl_element_t *e);
+unsigned int io_seproxyhal_touch_descriptor_ok(const bagl_element_t *e);
+unsigned int io_seproxyhal_touch_descriptor_cancel(const bagl_element_t *e);
 void io_exchange_with_code(uint16_t code, uint32_t tx);
 void ui_idle(void);
 
 uint32_t get_public_key_and_set_result(void);
 uint32_t sign_hash_and_set_result(void);
+uint32_t sign_stored_hash_and_set_result(void);
 
 #define MAX_BIP32_PATH 10
 
@@ -45,12 +48,28 @@ uint32_t sign_hash_and_set_result(void);
 #define INS_GET_PUBLIC_KEY 0x02
 #define INS_SIGN 0x04
 #define INS_GET_APP_CONFIGURATION 0x06
+#define INS_SIGNING_SESSION 0x08
+#define INS_ABI_DESCRIPTOR 0x0A
 #define P1_CONFIRM 0x01
 #define P1_NON_CONFIRM 0x00
 #define P2_NO_CHAINCODE 0x00
 #define P2_CHAINCODE 0x01
 #define P1_FIRST 0x00
 #define P1_MORE 0x80
+// First chunk of a transaction using the path and chain id of the session
+#define P1_SESSION_FIRST 0x01
+// Chunk preceded by its sequence number, see resumeChunk
+#define P1_RESUME 0x02
+// Manifest of the next transaction, checked before it is streamed
+#define P1_MANIFEST 0x03
+#define P1_SESSION_OPEN 0x00
+#define P1_SESSION_CLOSE 0x01
+// Session chain selector: index into KNOWN_CHAIN_IDS or a chain id follows
+#define CHAIN_ID_CUSTOM 0xFF
+// Signing P2 selects the transaction encoding, values match txEncoding_e
+#define P2_SIGN_TLV 0x00
+#define P2_SIGN_RAW 0x01
+#define P2_SIGN_RAW_NAMES 0x02
 
 #define OFFSET_CLA 0
 #define OFFSET_INS 1
@@ -64,6 +83,22 @@ uint8_t const SECP256K1_N[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
                                0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b,
                                0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41};
 
+// EOS, Jungle 3, Kylin, Telos and WAX
+uint8_t const KNOWN_CHAIN_IDS[][32] = {
+    {0xac, 0xa3, 0x76, 0xf2, 0x06, 0xb8, 0xfc, 0x25, 0xa6, 0xed, 0x44, 0xdb, 0xdc, 0x66, 0x54, 0x7c,
+     0x36, 0xc6, 0xc3, 0x3e, 0x3a, 0x11, 0x9f, 0xfb, 0xea, 0xef, 0x94, 0x36, 0x42, 0xf0, 0xe9, 0x06},
+    {0x2a, 0x02, 0xa0, 0x05, 0x3e, 0x5a, 0x8c, 0xf7, 0x3a, 0x56, 0xba, 0x0f, 0xda, 0x11, 0xe4, 0xd9,
+     0x2e, 0x02, 0x38, 0xa4, 0xa2, 0xaa, 0x74, 0xfc, 0xcf, 0x46, 0xd5, 0xa9, 0x10, 0x74, 0x68, 0x40},
+    {0x5f, 0xff, 0x1d, 0xae, 0x8d, 0xc8, 0xe2, 0xfc, 0x4d, 0x5b, 0x23, 0xb2, 0xc7, 0x66, 0x5c, 0x97,
+     0xf9, 0xe9, 0xd8, 0xed, 0xf2, 0xb6, 0x48, 0x5a, 0x86, 0xba, 0x31, 0x1c, 0x25, 0x63, 0x91, 0x91},
+    {0x46, 0x67, 0xb2, 0x05, 0xc6, 0x83, 0x8e, 0xf7, 0x0f, 0xf7, 0x98, 0x8f, 0x6e, 0x82, 0x57, 0xe8,
+     0xbe, 0x0e, 0x12, 0x84, 0xa2, 0xf5, 0x96, 0x99, 0x05, 0x4a, 0x01, 0x8f, 0x74, 0x3b, 0x1d, 0x11},
+    {0x10, 0x64, 0x48, 0x7b, 0x3c, 0xd1, 0xa8, 0x97, 0xce, 0x03, 0xae, 0x5b, 0x6a, 0x86, 0x56, 0x51,
+     0x74, 0x7e, 0x2e, 0x15, 0x20, 0x90, 0xf9, 0x9c, 0x1d, 0x19, 0xd4, 0x4e, 0x01, 0xae, 0xa5, 0xa4}
+};
+
+#define KNOWN_CHAIN_COUNT (sizeof(KNOWN_CHAIN_IDS) / sizeof(KNOWN_CHAIN_IDS[0]))
+
 typedef struct publicKeyContext_t
 {
     cx_ecfp_public_key_t publicKey;
@@ -77,18 +112,69 @@ typedef struct transactionContext_t
     uint8_t pathLength;
     uint32_t bip32Path[MAX_BIP32_PATH];
     uint8_t hash[32];
+    // Chunks answered since the first one
+    uint16_t chunks;
+    // Last chunk received, its SHA-256 and where it is in G_io_apdu_buffer
+    uint8_t chunkHash[32];
+    uint8_t chunkLength;
+    uint8_t chunkOffset;
+    // Review shown for the last chunk, STREAM_PROCESSING once answered
+    uint8_t pendingStatus;
+    // Signature sent, hash holds the transaction digest
+    bool finished;
+    // Manifest for the next transaction, cleared once it starts
+    txManifest_t manifest;
 } transactionContext_t;
 
-cx_sha256_t sha256;
-cx_sha256_t dataSha256;
-
+typedef struct descriptorContext_t
+{
+    abiDescriptor_t descriptor;
+    // SHA-256 of the descriptor as received, approved by the user
+    char hash[65];
+    char contract[14];
+    char action[14];
+} descriptorContext_t;
+
+/**
+ * Public key export, descriptor upload and signing never run at the same
+ * time, so signing state is overlaid with the other contexts.
+ * tmpCtxOwner tells which of them is live.
+*/
 union {
     publicKeyContext_t publicKeyContext;
-    transactionContext_t transactionContext;
+    descriptorContext_t descriptorContext;
+    struct {
+        transactionContext_t transactionContext;
+        cx_sha256_t sha256;
+        cx_sha256_t dataSha256;
+        txProcessingContext_t txProcessingCtx;
+        txProcessingContent_t txContent;
+    };
 } tmpCtx;
 
-txProcessingContext_t txProcessingCtx;
-txProcessingContent_t txContent;
+RAM_BUDGET_ASSERT(tmpCtx, SIGNING_RAM_BUDGET);
+
+/**
+ * Path and chain id set once by INS_SIGNING_SESSION for transactions
+ * started with P1_SESSION_FIRST. Not part of tmpCtx, so public key
+ * requests between transactions keep the session open.
+*/
+typedef struct signingSession_t
+{
+    bool open;
+    uint8_t pathLength;
+    uint32_t bip32Path[MAX_BIP32_PATH];
+    uint8_t chainId[32];
+} signingSession_t;
+
+signingSession_t signingSession;
+
+#define TMP_CTX_NONE 0
+#define TMP_CTX_PUBLIC_KEY 1
+#define TMP_CTX_SIGNING 2
+#define TMP_CTX_DESCRIPTOR 3
+
+uint8_t tmpCtxOwner;
 
 volatile char actionCounter[32];
 volatile char confirmLabel[32];
@@ -104,6 +190,8 @@ unsigned int ux_step_count;
 typedef struct internalStorage_t {
     uint8_t dataAllowed;
     uint8_t initialized;
+    // Action descriptors approved by the user, see INS_ABI_DESCRIPTOR
+    abiDescriptorStore_t descriptors;
 } internalStorage_t;
 
 const internalStorage_t N_storage_real;
@@ -247,6 +335,64 @@ UX_FLOW(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+UX_STEP_NOCB(
+    ux_descriptor_flow_1_step,
+    pnn,
+    {
+      &C_icon_eye,
+      "Review",
+      "descriptor",
+    });
+UX_STEP_NOCB(
+    ux_descriptor_flow_2_step,
+    bn,
+    {
+      "Contract",
+      tmpCtx.descriptorContext.contract,
+    });
+UX_STEP_NOCB(
+    ux_descriptor_flow_3_step,
+    bn,
+    {
+      "Action",
+      tmpCtx.descriptorContext.action,
+    });
+UX_STEP_NOCB(
+    ux_descriptor_flow_4_step,
+    bnnn_paging,
+    {
+      .title = "Hash",
+      .text = tmpCtx.descriptorContext.hash,
+    });
+UX_STEP_CB(
+    ux_descriptor_flow_5_step,
+    pb,
+    io_seproxyhal_touch_descriptor_ok(NULL),
+    {
+      &C_icon_validate_14,
+      "Approve",
+    });
+UX_STEP_CB(
+    ux_descriptor_flow_6_step,
+    pb,
+    io_seproxyhal_touch_descriptor_cancel(NULL),
+    {
+      &C_icon_crossmark,
+      "Reject",
+    });
+
+UX_FLOW(
+    ux_descriptor_flow,
+    &ux_descriptor_flow_1_step,
+    &ux_descriptor_flow_2_step,
+    &ux_descriptor_flow_3_step,
+    &ux_descriptor_flow_4_step,
+    &ux_descriptor_flow_5_step,
+    &ux_descriptor_flow_6_step
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
 #define STATE_LEFT_BORDER 0
 #define STATE_VARIABLE 1
 #define STATE_RIGHT_BORDER 2
@@ -270,14 +416,14 @@ UX_STEP_NOCB(
     bn,
     {
       "Contract",
-      txContent.contract,
+      tmpCtx.txContent.contract,
     });
 UX_STEP_NOCB(
     ux_single_action_sign_flow_3_step,
     bn,
     {
       "Action",
-      txContent.action,
+      tmpCtx.txContent.action,
     });
 UX_STEP_INIT(
     ux_init_left_border,
@@ -294,8 +440,8 @@ UX_STEP_NOCB_INIT(
         display_next_state(STATE_VARIABLE);
     },
     {
-      .title = txContent.arg.label,
-      .text = txContent.arg.data,
+      .title = tmpCtx.txContent.arg.label,
+      .text = tmpCtx.txContent.arg.data,
     });
 
 UX_STEP_INIT(
@@ -337,6 +483,25 @@ UX_FLOW(
     &ux_single_action_sign_flow_8_step
 );
 
+UX_STEP_NOCB(
+    ux_summary_sign_flow_1_step,
+    pnn,
+    {
+      &C_icon_certificate,
+      "Summary",
+      confirmLabel,
+    });
+
+UX_FLOW(
+    ux_summary_sign_flow,
+    &ux_summary_sign_flow_1_step,
+    &ux_init_left_border,
+    &ux_single_action_sign_flow_variable_step,
+    &ux_init_right_border,
+    &ux_single_action_sign_flow_7_step,
+    &ux_single_action_sign_flow_8_step
+);
+
 void display_next_state(uint8_t state) 
 {
     if (state == STATE_LEFT_BORDER)
@@ -359,7 +524,13 @@ void display_next_state(uint8_t state)
     }
     else if (state == STATE_VARIABLE)
     {
-        printArgument(ux_step-1, &txProcessingCtx);
+        if (!printArgument(ux_step-1, &tmpCtx.txProcessingCtx))
+        {
+            // Reject the pending APDU, the action can not be displayed
+            tmpCtx.txProcessingCtx.state = TLV_NONE;
+            io_exchange_with_code(0x6A80, 0);
+            ui_idle();
+        }
     }
     else if (state == STATE_RIGHT_BORDER)
     {
@@ -381,20 +552,89 @@ void display_next_state(uint8_t state)
     }
 }
 
+/**
+ * Once the argument screen is drawn, the arguments either side of it are
+ * formatted so the next button press only swaps screens. Only while a
+ * review is pending: once its chunk is answered G_io_apdu_buffer is reused.
+*/
+static void prefetchReviewScreens(void)
+{
+    if (tmpCtxOwner != TMP_CTX_SIGNING || tmpCtx.txProcessingCtx.state == TLV_NONE ||
+        tmpCtx.transactionContext.pendingStatus == STREAM_PROCESSING)
+    {
+        return;
+    }
+    while (prefetchArgument(&tmpCtx.txProcessingCtx))
+    {
+    }
+}
+
+/**
+ * Mark the descriptor slot as most recently used. NVM is only written
+ * when another slot was used last.
+*/
+static void touchAbiDescriptor(uint8_t slot)
+{
+    uint32_t clock = N_storage.descriptors.clock;
+    if (N_storage.descriptors.used[slot] == clock && clock != 0)
+    {
+        return;
+    }
+    clock++;
+    nvm_write((void *)&N_storage.descriptors.used[slot], &clock, sizeof(clock));
+    nvm_write((void *)&N_storage.descriptors.clock, &clock, sizeof(clock));
+}
+
+/**
+ * An action about to be reviewed keeps its descriptor in the cache.
+*/
+static void touchCurrentAbiDescriptor(void)
+{
+    const abiDescriptor_t *descriptor = currentAbiDescriptor(&tmpCtx.txProcessingCtx);
+    if (descriptor != NULL)
+    {
+        touchAbiDescriptor(descriptor - (const abiDescriptor_t *)N_storage.descriptors.slots);
+    }
+}
+
+/**
+ * A run of actions is confirmed as one summary, the action that ended it
+ * is still ready and reviewed next. Without one the transaction is signed.
+*/
+static void displaySummary(void)
+{
+    bool last = !tmpCtx.txProcessingCtx.actionReady;
+    ux_step = 0;
+    ux_step_count = tmpCtx.txContent.argumentCount;
+    format_label((char *)confirmLabel, sizeof(confirmLabel), "%d actions", tmpCtx.txContent.summary.actions, 0);
+    strcpy((char *)confirm_text1, last ? "Sign" : "Accept");
+    strcpy((char *)confirm_text2, last ? "transaction" : "& review next");
+
+    tmpCtx.transactionContext.pendingStatus = STREAM_SUMMARY_READY;
+    ux_flow_init(0, ux_summary_sign_flow, NULL);
+}
+
 void ux_single_action_sign_flow_ok_pressed() 
 {
-    parserStatus_e txResult = parseTx(&txProcessingCtx, NULL, 0);
+    parserStatus_e txResult = parseTx(&tmpCtx.txProcessingCtx, NULL, 0);
     switch (txResult) {
     case STREAM_ACTION_READY:
         ux_step = 0;
-        ux_step_count = txContent.argumentCount;
-        snprintf((char *)confirmLabel, sizeof(confirmLabel), "Action #%d", txProcessingCtx.currentActionIndex);
-        strcpy((char *)confirm_text1, txProcessingCtx.currentActionIndex == txProcessingCtx.currentActionNumer ? "Sign" : "Accept");
-        strcpy((char *)confirm_text2, txProcessingCtx.currentActionIndex == txProcessingCtx.currentActionNumer ? "transaction" : "& review next");
+        ux_step_count = tmpCtx.txContent.argumentCount;
+        format_label((char *)confirmLabel, sizeof(confirmLabel), "Action #%d", tmpCtx.txProcessingCtx.currentActionIndex + (tmpCtx.txProcessingCtx.actionPage ? 1 : 0), 0);
+        strcpy((char *)confirm_text1, tmpCtx.txProcessingCtx.currentActionIndex == tmpCtx.txProcessingCtx.currentActionNumer ? "Sign" : "Accept");
+        strcpy((char *)confirm_text2, tmpCtx.txProcessingCtx.currentActionIndex == tmpCtx.txProcessingCtx.currentActionNumer ? "transaction" : "& review next");
 
+        tmpCtx.transactionContext.pendingStatus = txResult;
+        touchCurrentAbiDescriptor();
         ux_flow_init(0, ux_single_action_sign_flow, NULL);
         break;
+    case STREAM_SUMMARY_READY:
+        displaySummary();
+        break;
     case STREAM_PROCESSING:
+        tmpCtx.transactionContext.pendingStatus = STREAM_PROCESSING;
+        tmpCtx.transactionContext.chunks++;
         io_exchange_with_code(0x9000, 0);
         // Display back the original UX
         ui_idle();
@@ -414,6 +654,7 @@ void ux_single_action_sign_flow_ok_pressed()
 ///////////////////////////////////////////////////////////////////////////////
 
 void ux_multiple_action_sign_flow_ok_pressed();
+void ux_multiple_action_sign_flow_summary_pressed();
 
 UX_FLOW_DEF_NOCB(
     ux_multiple_action_sign_flow_1_step,
@@ -439,6 +680,15 @@ UX_FLOW_DEF_VALID(
       "Continue",
       "review"
     });
+UX_FLOW_DEF_VALID(
+    ux_multiple_action_sign_flow_summary_step,
+    pbb,
+    ux_multiple_action_sign_flow_summary_pressed(),
+    {
+      &C_icon_eye,
+      "Review",
+      "summary",
+    });
 UX_FLOW_DEF_VALID(
     ux_multiple_action_sign_flow_4_step,
     pbb,
@@ -454,24 +704,32 @@ UX_FLOW(
     &ux_multiple_action_sign_flow_1_step,
     &ux_multiple_action_sign_flow_2_step,
     &ux_multiple_action_sign_flow_3_step,
+    &ux_multiple_action_sign_flow_summary_step,
     &ux_multiple_action_sign_flow_4_step
 );
 
 void ux_multiple_action_sign_flow_ok_pressed()
 {
-    parserStatus_e txResult = parseTx(&txProcessingCtx, NULL, 0);
+    parserStatus_e txResult = parseTx(&tmpCtx.txProcessingCtx, NULL, 0);
     switch (txResult) {
     case STREAM_ACTION_READY:
         ux_step = 0;
-        ux_step_count = txContent.argumentCount;
-        snprintf((char *)confirmLabel, sizeof(confirmLabel), "Action #%d", txProcessingCtx.currentActionIndex);
-        strcpy((char *)confirm_text1, txProcessingCtx.currentActionIndex == txProcessingCtx.currentActionNumer ? "Sign" : "Accept");
-        strcpy((char *)confirm_text2, txProcessingCtx.currentActionIndex == txProcessingCtx.currentActionNumer ? "transaction" : "& review next");
+        ux_step_count = tmpCtx.txContent.argumentCount;
+        format_label((char *)confirmLabel, sizeof(confirmLabel), "Action #%d", tmpCtx.txProcessingCtx.currentActionIndex + (tmpCtx.txProcessingCtx.actionPage ? 1 : 0), 0);
+        strcpy((char *)confirm_text1, tmpCtx.txProcessingCtx.currentActionIndex == tmpCtx.txProcessingCtx.currentActionNumer ? "Sign" : "Accept");
+        strcpy((char *)confirm_text2, tmpCtx.txProcessingCtx.currentActionIndex == tmpCtx.txProcessingCtx.currentActionNumer ? "transaction" : "& review next");
 
+        tmpCtx.transactionContext.pendingStatus = txResult;
+        touchCurrentAbiDescriptor();
         ux_flow_init(0, ux_single_action_sign_flow, NULL);
 
+        break;
+    case STREAM_SUMMARY_READY:
+        displaySummary();
         break;
     case STREAM_PROCESSING:
+        tmpCtx.transactionContext.pendingStatus = STREAM_PROCESSING;
+        tmpCtx.transactionContext.chunks++;
         io_exchange_with_code(0x9000, 0);
         // Display back the original UX
         ui_idle();
@@ -487,6 +745,16 @@ void ux_multiple_action_sign_flow_ok_pressed()
     }
 }
 
+/**
+ * Opt-in summary mode: runs of transfers to distinct recipients are
+ * confirmed as one summary, each action is reviewed in full otherwise.
+*/
+void ux_multiple_action_sign_flow_summary_pressed()
+{
+    setTxSummary(&tmpCtx.txProcessingCtx, true);
+    ux_multiple_action_sign_flow_ok_pressed();
+}
+
 
 void ui_idle(void)
 {
@@ -521,6 +789,29 @@ unsigned int io_seproxyhal_touch_address_cancel(const bagl_element_t *e)
     return 0; // do not redraw the widget
 }
 
+unsigned int io_seproxyhal_touch_descriptor_ok(const bagl_element_t *e)
+{
+    const abiDescriptor_t *descriptor = &tmpCtx.descriptorContext.descriptor;
+    uint8_t slot = abiDescriptorSlot((const abiDescriptorStore_t *)&N_storage.descriptors,
+                                     descriptor->contract, descriptor->action);
+    nvm_write((void *)&N_storage.descriptors.slots[slot], (void *)descriptor, sizeof(abiDescriptor_t));
+    touchAbiDescriptor(slot);
+    tmpCtxOwner = TMP_CTX_NONE;
+    io_exchange_with_code(0x9000, 0);
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_descriptor_cancel(const bagl_element_t *e)
+{
+    tmpCtxOwner = TMP_CTX_NONE;
+    io_exchange_with_code(0x6985, 0);
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
 unsigned int io_seproxyhal_touch_tx_ok(const bagl_element_t *e)
 {
     uint32_t tx = sign_hash_and_set_result();
@@ -533,6 +824,8 @@ unsigned int io_seproxyhal_touch_tx_ok(const bagl_element_t *e)
 
 unsigned int io_seproxyhal_touch_tx_cancel(const bagl_element_t *e)
 {
+    // A rejected transaction can not be resumed
+    tmpCtx.txProcessingCtx.state = TLV_NONE;
     io_exchange_with_code(0x6985, 0);
     // Display back the original UX
     ui_idle();
@@ -628,6 +921,7 @@ void handleGetPublicKey(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
                        (dataBuffer[2] << 8) | (dataBuffer[3]);
         dataBuffer += 4;
     }
+    tmpCtxOwner = TMP_CTX_PUBLIC_KEY;
     tmpCtx.publicKeyContext.getChaincode = (p2 == P2_CHAINCODE);
     os_perso_derive_node_bip32(CX_CURVE_256K1, bip32Path, bip32PathLength,
                                privateKeyData,
@@ -639,8 +933,12 @@ void handleGetPublicKey(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
                           &privateKey, 1);
     os_memset(&privateKey, 0, sizeof(privateKey));
     os_memset(privateKeyData, 0, sizeof(privateKeyData));
-    public_key_to_wif(tmpCtx.publicKeyContext.publicKey.W, sizeof(tmpCtx.publicKeyContext.publicKey.W),
-                      tmpCtx.publicKeyContext.address, sizeof(tmpCtx.publicKeyContext.address));
+    uint32_t addressLength;
+    if (!public_key_to_wif(tmpCtx.publicKeyContext.publicKey.W, sizeof(tmpCtx.publicKeyContext.publicKey.W),
+                           tmpCtx.publicKeyContext.address, sizeof(tmpCtx.publicKeyContext.address), &addressLength))
+    {
+        THROW(0x6A80);
+    }
     if (p1 == P1_NON_CONFIRM)
     {
         *tx = get_public_key_and_set_result();
@@ -675,9 +973,22 @@ void handleGetAppConfiguration(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
 uint32_t sign_hash_and_set_result(void) 
 {
     // store hash
-    cx_hash(&sha256.header, CX_LAST, tmpCtx.transactionContext.hash, 0, 
+    cx_hash(&tmpCtx.sha256.header, CX_LAST, tmpCtx.transactionContext.hash, 0, 
         tmpCtx.transactionContext.hash, sizeof(tmpCtx.transactionContext.hash));
 
+    // The signature answers the last chunk
+    tmpCtx.transactionContext.finished = true;
+    tmpCtx.transactionContext.pendingStatus = STREAM_PROCESSING;
+    tmpCtx.transactionContext.chunks++;
+    return sign_stored_hash_and_set_result();
+}
+
+/**
+ * RFC 6979 nonces make the signature deterministic, so signing the 
+ * stored hash again answers a retransmitted last chunk identically.
+*/
+uint32_t sign_stored_hash_and_set_result(void)
+{
     uint8_t privateKeyData[64];
     cx_ecfp_private_key_t privateKey;
     uint32_t tx = 0;
@@ -730,52 +1041,110 @@ uint32_t sign_hash_and_set_result(void)
     return tx;
 }
 
-void handleSign(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                uint16_t dataLength, volatile unsigned int *flags,
-                volatile unsigned int *tx)
+/**
+ * Reads a length prefixed BIP32 path and advances past it.
+*/
+static void readBip32Path(uint8_t **workBuffer, uint16_t *dataLength,
+                          uint8_t *pathLength, uint32_t *bip32Path)
 {
     uint32_t i;
-    parserStatus_e txResult;
-    if (p1 == P1_FIRST)
+    uint8_t *buffer = *workBuffer;
+    *pathLength = buffer[0];
+    if ((*pathLength < 0x01) || (*pathLength > MAX_BIP32_PATH) ||
+        (*dataLength < 1 + 4 * *pathLength))
     {
-        tmpCtx.transactionContext.pathLength = workBuffer[0];
-        if ((tmpCtx.transactionContext.pathLength < 0x01) ||
-            (tmpCtx.transactionContext.pathLength > MAX_BIP32_PATH))
-        {
-            PRINTF("Invalid path\n");
-            THROW(0x6a80);
-        }
-        workBuffer++;
-        dataLength--;
-        for (i = 0; i < tmpCtx.transactionContext.pathLength; i++)
-        {
-            tmpCtx.transactionContext.bip32Path[i] =
-                (workBuffer[0] << 24) | (workBuffer[1] << 16) |
-                (workBuffer[2] << 8) | (workBuffer[3]);
-            workBuffer += 4;
-            dataLength -= 4;
-        }
-        initTxContext(&txProcessingCtx, &sha256, &dataSha256, &txContent, N_storage.dataAllowed);
+        PRINTF("Invalid path\n");
+        THROW(0x6a80);
     }
-    else if (p1 != P1_MORE)
+    buffer++;
+    for (i = 0; i < *pathLength; i++)
+    {
+        bip32Path[i] =
+            (buffer[0] << 24) | (buffer[1] << 16) |
+            (buffer[2] << 8) | (buffer[3]);
+        buffer += 4;
+    }
+    *workBuffer = buffer;
+    *dataLength -= 1 + 4 * *pathLength;
+}
+
+void handleSigningSession(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                          uint16_t dataLength, volatile unsigned int *flags,
+                          volatile unsigned int *tx)
+{
+    UNUSED(p2);
+    UNUSED(flags);
+    UNUSED(tx);
+    if (p1 == P1_SESSION_CLOSE)
+    {
+        os_memset(&signingSession, 0, sizeof(signingSession));
+        THROW(0x9000);
+    }
+    if (p1 != P1_SESSION_OPEN)
     {
         THROW(0x6B00);
     }
-    if (p2 != 0)
+    signingSession.open = false;
+    readBip32Path(&workBuffer, &dataLength, &signingSession.pathLength, signingSession.bip32Path);
+    if (dataLength == 1 && workBuffer[0] < KNOWN_CHAIN_COUNT)
+    {
+        os_memmove(signingSession.chainId, PIC(KNOWN_CHAIN_IDS[workBuffer[0]]), sizeof(signingSession.chainId));
+    }
+    else if (dataLength == 1 + sizeof(signingSession.chainId) && workBuffer[0] == CHAIN_ID_CUSTOM)
+    {
+        os_memmove(signingSession.chainId, workBuffer + 1, sizeof(signingSession.chainId));
+    }
+    else
+    {
+        PRINTF("Invalid chain id\n");
+        THROW(0x6A80);
+    }
+    signingSession.open = true;
+    THROW(0x9000);
+}
+
+/**
+ * Descriptor of an action the registry does not know, rendered once the
+ * user approves its hash. It is kept in NVM, replacing the descriptor of
+ * the same action or else the least recently used one, so later
+ * transactions do not send it again. A transaction in progress is lost.
+*/
+void handleAbiDescriptor(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                         uint16_t dataLength, volatile unsigned int *flags,
+                         volatile unsigned int *tx)
+{
+    descriptorContext_t *context = &tmpCtx.descriptorContext;
+    uint8_t hash[32];
+    uint32_t written;
+    UNUSED(tx);
+    if (p1 != 0 || p2 != 0)
     {
         THROW(0x6B00);
     }
-    if (txProcessingCtx.state == TLV_NONE)
+    tmpCtxOwner = TMP_CTX_DESCRIPTOR;
+    if (!checkAbiDescriptor(workBuffer, dataLength, &context->descriptor))
     {
-        PRINTF("Parser not initialized\n");
-        THROW(0x6985);
+        tmpCtxOwner = TMP_CTX_NONE;
+        THROW(0x6A80);
     }
+    cx_hash_sha256(workBuffer, dataLength, hash, sizeof(hash));
+    array_hexstr(context->hash, hash, sizeof(hash));
+    os_memset(context->contract, 0, sizeof(context->contract));
+    os_memset(context->action, 0, sizeof(context->action));
+    name_to_string(context->descriptor.contract, context->contract, sizeof(context->contract), &written);
+    name_to_string(context->descriptor.action, context->action, sizeof(context->action), &written);
+    ux_flow_init(0, ux_descriptor_flow, NULL);
+    *flags |= IO_ASYNCH_REPLY;
+}
 
-    txResult = parseTx(&txProcessingCtx, workBuffer, dataLength);
+static void handleTxResult(parserStatus_e txResult, volatile unsigned int *flags,
+                           volatile unsigned int *tx)
+{
     switch (txResult)
     {
     case STREAM_CONFIRM_PROCESSING:
-        snprintf((char *)actionCounter, sizeof(actionCounter), "%d actions", txProcessingCtx.currentActionNumer);
+        format_label((char *)actionCounter, sizeof(actionCounter), "%d actions", tmpCtx.txProcessingCtx.currentActionNumer, 0);
+        tmpCtx.transactionContext.pendingStatus = txResult;
         ux_flow_init(0, ux_multiple_action_sign_flow, NULL);
 
         *flags |= IO_ASYNCH_REPLY;
@@ -783,26 +1152,35 @@ void handleSign(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
         break;
     case STREAM_ACTION_READY:
         ux_step = 0;
-        ux_step_count = txContent.argumentCount;
+        ux_step_count = tmpCtx.txContent.argumentCount;
 
-        if (txProcessingCtx.currentActionNumer > 1) {
-            snprintf((char *)confirmLabel, sizeof(confirmLabel), "Action #%d", txProcessingCtx.currentActionIndex);
+        if (tmpCtx.txProcessingCtx.currentActionNumer > 1) {
+            format_label((char *)confirmLabel, sizeof(confirmLabel), "Action #%d", tmpCtx.txProcessingCtx.currentActionIndex + (tmpCtx.txProcessingCtx.actionPage ? 1 : 0), 0);
         } else {
             strcpy((char *)confirmLabel, "Transaction");         
         }
 
-        strcpy((char *)confirm_text1, txProcessingCtx.currentActionIndex == txProcessingCtx.currentActionNumer ? "Sign" : "Accept");
-        strcpy((char *)confirm_text2, txProcessingCtx.currentActionIndex == txProcessingCtx.currentActionNumer ? "transaction" : "& review next");
+        strcpy((char *)confirm_text1, tmpCtx.txProcessingCtx.currentActionIndex == tmpCtx.txProcessingCtx.currentActionNumer ? "Sign" : "Accept");
+        strcpy((char *)confirm_text2, tmpCtx.txProcessingCtx.currentActionIndex == tmpCtx.txProcessingCtx.currentActionNumer ? "transaction" : "& review next");
         
+        tmpCtx.transactionContext.pendingStatus = txResult;
+        touchCurrentAbiDescriptor();
         ux_flow_init(0, ux_single_action_sign_flow, NULL);
 
         *flags |= IO_ASYNCH_REPLY;
 
+        break;
+    case STREAM_SUMMARY_READY:
+        displaySummary();
+
+        *flags |= IO_ASYNCH_REPLY;
+
         break;
     case STREAM_FINISHED:
         *tx = sign_hash_and_set_result();
         THROW(0x9000);
     case STREAM_PROCESSING:
+        tmpCtx.transactionContext.chunks++;
         THROW(0x9000);
     case STREAM_FAULT:
         THROW(0x6A80);
@@ -812,6 +1190,175 @@ void handleSign(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
     }
 }
 
+/**
+ * A resent chunk must be the one received: its arguments under review
+ * were hashed from those bytes. Compared in constant time.
+*/
+static bool isLastChunk(const uint8_t *workBuffer, uint16_t dataLength)
+{
+    const transactionContext_t *transaction = &tmpCtx.transactionContext;
+    uint8_t hash[32];
+    uint8_t diff = 0;
+    uint8_t i;
+
+    if (dataLength != transaction->chunkLength)
+    {
+        return false;
+    }
+    cx_hash_sha256((uint8_t *)workBuffer, dataLength, hash, sizeof(hash));
+    for (i = 0; i < sizeof(hash); ++i)
+    {
+        diff |= hash[i] ^ transaction->chunkHash[i];
+    }
+    return diff == 0;
+}
+
+/**
+ * P1_RESUME, sent after a transport drop. tmpCtx only changes when a
+ * chunk is parsed or an action approved, so it is the checkpoint: parser
+ * state, digest midstates and index of the last approved action survive
+ * the drop. Returns false for the next chunk, which is parsed as usual.
+ * The last chunk answered is answered again without parsing it, the
+ * chunk under review is put back where the parser references it and its
+ * pending review is shown again. Any other sequence number is rejected 
+ * with the one expected.
+*/
+static bool resumeChunk(uint16_t sequence, uint8_t *workBuffer, uint16_t dataLength,
+                        volatile unsigned int *flags, volatile unsigned int *tx)
+{
+    transactionContext_t *transaction = &tmpCtx.transactionContext;
+    bool pending = (transaction->pendingStatus != STREAM_PROCESSING);
+    bool received = isLastChunk(workBuffer, dataLength);
+
+    if (sequence == transaction->chunks && !pending)
+    {
+        return false;
+    }
+    if (sequence == transaction->chunks && received)
+    {
+        os_memmove(G_io_apdu_buffer + transaction->chunkOffset, workBuffer, dataLength);
+        handleTxResult((parserStatus_e)transaction->pendingStatus, flags, tx);
+        return true;
+    }
+    if (sequence + 1 == transaction->chunks && !pending && received)
+    {
+        if (transaction->finished)
+        {
+            *tx = sign_stored_hash_and_set_result();
+        }
+        THROW(0x9000);
+    }
+    G_io_apdu_buffer[0] = transaction->chunks >> 8;
+    G_io_apdu_buffer[1] = transaction->chunks;
+    *tx = 2;
+    THROW(0x6985);
+    return false;
+}
+
+void handleSign(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                uint16_t dataLength, volatile unsigned int *flags,
+                volatile unsigned int *tx)
+{
+    if (p1 == P1_MANIFEST)
+    {
+        // Nothing is streamed until the host knows the transaction is supported
+        tmpCtxOwner = TMP_CTX_SIGNING;
+        tmpCtx.txProcessingCtx.state = TLV_NONE;
+        if (!checkTxManifest(workBuffer, dataLength, N_storage.dataAllowed,
+                             (const abiDescriptorStore_t *)&N_storage.descriptors,
+                             &tmpCtx.transactionContext.manifest))
+        {
+            tmpCtx.transactionContext.manifest.actions = 0;
+            THROW(0x6A80);
+        }
+        THROW(0x9000);
+    }
+    if (p1 == P1_FIRST || p1 == P1_SESSION_FIRST)
+    {
+        txManifest_t manifest = {0};
+        if (tmpCtxOwner == TMP_CTX_SIGNING)
+        {
+            manifest = tmpCtx.transactionContext.manifest;
+            tmpCtx.transactionContext.manifest.actions = 0;
+        }
+        if (p1 == P1_FIRST)
+        {
+            readBip32Path(&workBuffer, &dataLength, &tmpCtx.transactionContext.pathLength,
+                          tmpCtx.transactionContext.bip32Path);
+        }
+        else if (signingSession.open)
+        {
+            tmpCtx.transactionContext.pathLength = signingSession.pathLength;
+            os_memmove(tmpCtx.transactionContext.bip32Path, signingSession.bip32Path,
+                       sizeof(signingSession.bip32Path));
+        }
+        else
+        {
+            PRINTF("No signing session\n");
+            THROW(0x6985);
+        }
+        if ((p2 != P2_SIGN_TLV) && (p2 != P2_SIGN_RAW) && (p2 != P2_SIGN_RAW_NAMES))
+        {
+            THROW(0x6B00);
+        }
+        tmpCtxOwner = TMP_CTX_SIGNING;
+        tmpCtx.transactionContext.chunks = 0;
+        tmpCtx.transactionContext.pendingStatus = STREAM_PROCESSING;
+        tmpCtx.transactionContext.finished = false;
+        initTxContext(&tmpCtx.txProcessingCtx, &tmpCtx.sha256, &tmpCtx.dataSha256, &tmpCtx.txContent, N_storage.dataAllowed,
+                      (txEncoding_e)p2);
+        setTxDescriptors(&tmpCtx.txProcessingCtx, (const abiDescriptorStore_t *)&N_storage.descriptors);
+        if (p1 == P1_SESSION_FIRST)
+        {
+            // The stream starts with the transaction header
+            setTxChainId(&tmpCtx.txProcessingCtx, signingSession.chainId);
+        }
+        if (manifest.actions != 0)
+        {
+            setTxManifest(&tmpCtx.txProcessingCtx, &manifest);
+        }
+    }
+    else if (p1 != P1_MORE && p1 != P1_RESUME)
+    {
+        THROW(0x6B00);
+    }
+    if (tmpCtxOwner != TMP_CTX_SIGNING || tmpCtx.txProcessingCtx.state == TLV_NONE)
+    {
+        PRINTF("Parser not initialized\n");
+        THROW(0x6985);
+    }
+    // Every chunk of a transaction uses the encoding of the first one
+    if (p2 != tmpCtx.txProcessingCtx.encoding)
+    {
+        THROW(0x6B00);
+    }
+    if (p1 == P1_RESUME)
+    {
+        if (dataLength < 2)
+        {
+            THROW(0x6A80);
+        }
+        uint16_t sequence = (workBuffer[0] << 8) | workBuffer[1];
+        if (resumeChunk(sequence, workBuffer + 2, dataLength - 2, flags, tx))
+        {
+            return;
+        }
+        workBuffer += 2;
+        dataLength -= 2;
+    }
+    else if (tmpCtx.transactionContext.pendingStatus != STREAM_PROCESSING)
+    {
+        PRINTF("Chunk under review\n");
+        THROW(0x6985);
+    }
+
+    cx_hash_sha256(workBuffer, dataLength, tmpCtx.transactionContext.chunkHash,
+                   sizeof(tmpCtx.transactionContext.chunkHash));
+    tmpCtx.transactionContext.chunkLength = dataLength;
+    tmpCtx.transactionContext.chunkOffset = workBuffer - G_io_apdu_buffer;
+    handleTxResult(parseTx(&tmpCtx.txProcessingCtx, workBuffer, dataLength), flags, tx);
+}
+
 void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
 {
     unsigned short sw = 0;
@@ -841,6 +1388,20 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                            G_io_apdu_buffer[OFFSET_LC], flags, tx);
                 break;
 
+            case INS_SIGNING_SESSION:
+                handleSigningSession(G_io_apdu_buffer[OFFSET_P1],
+                                     G_io_apdu_buffer[OFFSET_P2],
+                                     G_io_apdu_buffer + OFFSET_CDATA,
+                                     G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+            case INS_ABI_DESCRIPTOR:
+                handleAbiDescriptor(G_io_apdu_buffer[OFFSET_P1],
+                                    G_io_apdu_buffer[OFFSET_P2],
+                                    G_io_apdu_buffer + OFFSET_CDATA,
+                                    G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
             case INS_GET_APP_CONFIGURATION:
                 handleGetAppConfiguration(
                     G_io_apdu_buffer[OFFSET_P1], 
@@ -994,7 +1555,9 @@ unsigned char io_event(unsigned char channel)
         break;
 
     case SEPROXYHAL_TAG_DISPLAY_PROCESSED_EVENT:
-        UX_DISPLAYED_EVENT({});
+        UX_DISPLAYED_EVENT({
+            prefetchReviewScreens();
+        });
         break;
     }
 
@@ -1047,11 +1610,14 @@ __attribute__((section(".boot"))) int main(void)
 
                 if (N_storage.initialized != 0x01)
                 {
-                    internalStorage_t storage;
-                    storage.dataAllowed = 0x00;
-                    storage.initialized = 0x01;
-                    nvm_write(&N_storage, (void *)&storage,
-                              sizeof(internalStorage_t));
+                    // The descriptor store is too large for the stack,
+                    // emptying its slots is enough
+                    uint8_t storage[2] = {0x00, 0x01};
+                    uint32_t used[ABI_DESCRIPTOR_SLOTS] = {0};
+                    uint32_t clock = 0;
+                    nvm_write((void *)N_storage.descriptors.used, (void *)used, sizeof(used));
+                    nvm_write((void *)&N_storage.descriptors.clock, (void *)&clock, sizeof(clock));
+                    nvm_write((void *)&N_storage, (void *)storage, sizeof(storage));
                 }
 
                 USB_power(0);
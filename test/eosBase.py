@@ -144,7 +144,7 @@ class Transaction:
             b = val & 0x7f
             val >>= 7
             b |= ((val > 0) << 7)
-            out += chr(b).encode()
+            out += bytes([b])
 
             if val == 0:
                 break
@@ -279,6 +279,31 @@ class Transaction:
         parameters += bytes([0x01]) if data['transfer'] else bytes([0x00])
         return parameters
 
+    @staticmethod
+    def parse_regproducer(data):
+        parameters = Transaction.name_to_number(data['producer'])
+        parameters += Transaction.parse_public_key(data['producer_key'])
+        url = data['url'].encode()
+        parameters += Transaction.pack_fc_uint(len(url)) + url
+        parameters += struct.pack('H', data['location'])
+        return parameters
+
+    @staticmethod
+    def parse_setprods(data):
+        parameters = Transaction.pack_fc_uint(len(data['schedule']))
+        for producer in data['schedule']:
+            parameters += Transaction.name_to_number(producer['producer_name'])
+            parameters += Transaction.parse_public_key(producer['block_signing_key'])
+        return parameters
+
+    @staticmethod
+    def parse_msig_approve(data):
+        parameters = Transaction.name_to_number(data['proposer'])
+        parameters += Transaction.name_to_number(data['proposal_name'])
+        parameters += Transaction.name_to_number(data['level']['actor'])
+        parameters += Transaction.name_to_number(data['level']['permission'])
+        return parameters
+
     @staticmethod
     def parse_unknown(data):
         data = data * 1000
@@ -318,7 +343,10 @@ class Transaction:
                 act.auth.append((Transaction.name_to_number(auth['actor']), Transaction.name_to_number(auth['permission'])))
 
             data = action['data']
-            if action['name'] == 'transfer':
+            if 'hex_data' in action:
+                # Serialized by the contract ABI, e.g. for uploaded descriptors
+                parameters = binascii.unhexlify(action['hex_data'])
+            elif action['name'] == 'transfer':
                 parameters = Transaction.parse_transfer(data)
             elif action['name'] == 'voteproducer':
                 parameters = Transaction.parse_vote_producer(data)
@@ -342,6 +370,12 @@ class Transaction:
                 parameters = Transaction.parse_newaccount(data)
             elif action['name'] == 'delegatebw':
                 parameters = Transaction.parse_delegate(data)
+            elif action['name'] == 'regproducer':
+                parameters = Transaction.parse_regproducer(data)
+            elif action['name'] == 'setprods':
+                parameters = Transaction.parse_setprods(data)
+            elif action['name'] in ('approve', 'unapprove'):
+                parameters = Transaction.parse_msig_approve(data)
             else:
                 parameters = Transaction.parse_unknown(data)
 
@@ -484,4 +518,68 @@ class Transaction:
         encoder.write(self.tx_ext, Numbers.OctetString)
         encoder.write(self.cfd, Numbers.OctetString)
 
-        return [encoder.output()]
\ No newline at end of file
+        return [encoder.output()]
+
+    def encode_raw(self):
+        """Plain EOS serialization, signed with P2 = 0x01. The device finds
+        field boundaries from the schema, so no per field TLV is sent."""
+        fields = [self.chain_id, self.expiration, self.ref_block_num, self.ref_block_prefix,
+                  self.net_usage_words, self.max_cpu_usage_ms, self.delay_sec,
+                  self.ctx_free_actions_size, self.actions_size]
+        for action in self.actions:
+            fields += [action.account, action.name, action.auth_size]
+            for auth in action.auth:
+                (auth_actor, permission) = auth
+                fields += [auth_actor, permission]
+            fields += [action.data_size, action.data]
+        fields += [self.tx_ext, self.cfd]
+        output = b''.join(fields)
+
+        print('Signing digest ' + hashlib.sha256(output).hexdigest())
+
+        return [output]
+    def manifest(self):
+        """Pre-flight manifest, sent with P1 = 0x03 before the transaction:
+        context free action count, action count, then account, name and
+        data size of every action. None if it does not fit one APDU."""
+        if len(self.actions) > 12:
+            return None
+        # Only a zero context free action count is accepted, a one byte varint
+        output = bytes(bytearray([bytearray(self.ctx_free_actions_size)[0], len(self.actions)]))
+        for action in self.actions:
+            output += action.account + action.name + struct.pack('<I', len(action.data))
+        return output
+
+    def encode_raw_names(self):
+        """Plain EOS serialization with name references, signed with P2 = 0x02.
+        Action and authorization names are sent as 0xFF followed by the name,
+        or as the index of one of the last 8 such literals (oldest replaced)."""
+        dictionary = []
+        oldest = 0
+
+        def encode_name(name):
+            nonlocal oldest
+            if name in dictionary:
+                return bytes([dictionary.index(name)])
+            if len(dictionary) < 8:
+                dictionary.append(name)
+            else:
+                dictionary[oldest] = name
+                oldest = (oldest + 1) % 8
+            return b'\xff' + name
+
+        fields = [self.chain_id, self.expiration, self.ref_block_num, self.ref_block_prefix,
+                  self.net_usage_words, self.max_cpu_usage_ms, self.delay_sec,
+                  self.ctx_free_actions_size, self.actions_size]
+        for action in self.actions:
+            fields += [encode_name(action.account), encode_name(action.name), action.auth_size]
+            for auth in action.auth:
+                (auth_actor, permission) = auth
+                fields += [encode_name(auth_actor), encode_name(permission)]
+            fields += [action.data_size, action.data]
+        fields += [self.tx_ext, self.cfd]
+
+        # Names are expanded on the device, the digest is the one of encode_raw
+        self.encode_raw()
+
+        return [b''.join(fields)]
@@ -0,0 +1,93 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+Signs several transactions in one signing session: the BIP 32 path and the
+chain id are sent once, every transaction then starts with its header.
+"""
+
+import binascii
+import json
+from eosBase import Transaction, parse_bip32_path
+from ledgerblue.comm import getDongle
+import argparse
+
+# Chains the device knows by index, see KNOWN_CHAIN_IDS in src/main.c
+KNOWN_CHAINS = [
+    'aca376f206b8fc25a6ed44dbdc66547c36c6c33e3a119ffbeaef943642f0e906',
+    '2a02a0053e5a8cf73a56ba0fda11e4d92e0238a4a2aa74fccf46d5a910746840',
+    '5fff1dae8dc8e2fc4d5b23b2c7665c97f9e9d8edf2b6485a86ba311c25639191',
+    '4667b205c6838ef70ff7988f6e8257e8be0e1284a2f59699054a018f743b1d11',
+    '1064487b3cd1a897ce03ae5b6a865651747e2e152090f99c1d19d44e01aea5a4',
+]
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path to retrieve")
+parser.add_argument('--file', nargs='+', help="Transactions in JSON format, all on the same chain")
+parser.add_argument('--raw', action='store_true', help="Send plain EOS serialization instead of DER fields")
+args = parser.parse_args()
+
+if args.path is None:
+    args.path = "44'/194'/0'/0/0"
+
+if args.file is None:
+    args.file = ['transaction.json']
+
+donglePath = parse_bip32_path(args.path)
+pathSize = len(donglePath) // 4
+p2 = "01" if args.raw else "00"
+
+transactions = []
+for path in args.file:
+    with open(path) as f:
+        obj = json.load(f)
+        transactions.append((obj, Transaction.parse(obj)))
+
+chain_id = transactions[0][0]['chain_id']
+if chain_id in KNOWN_CHAINS:
+    chain = bytes([KNOWN_CHAINS.index(chain_id)])
+else:
+    chain = b'\xff' + bytearray.fromhex(chain_id)
+
+dongle = getDongle(True)
+session = bytes([pathSize]) + donglePath + chain
+apdu = bytearray.fromhex("D4080000") + bytes([len(session)]) + session
+dongle.exchange(bytes(apdu))
+
+for (obj, tx) in transactions:
+    if obj['chain_id'] != chain_id:
+        raise ValueError("Transactions of a session must be on one chain")
+    if args.raw:
+        tx_chunk = b''.join(tx.encode_raw())[32:]
+    else:
+        # Chain id is the first field, a two byte DER header and 32 bytes
+        tx_chunk = b''.join(tx.encode2())[2 + 32:]
+
+    first = True
+    offset = 0
+    sliceSize = 150
+    while offset != len(tx_chunk):
+        transport_chunk = tx_chunk[offset: offset + sliceSize]
+        p1 = "01" if first else "80"
+        first = False
+        apdu = bytearray.fromhex("D404" + p1 + p2) + bytes([len(transport_chunk)]) + transport_chunk
+        offset += len(transport_chunk)
+        result = dongle.exchange(bytes(apdu))
+    print(binascii.hexlify(result))
+
+dongle.exchange(bytes(bytearray.fromhex("D408010000")))
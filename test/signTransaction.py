@@ -29,6 +29,10 @@ import argparse
 parser = argparse.ArgumentParser()
 parser.add_argument('--path', help="BIP 32 path to retrieve")
 parser.add_argument('--file', help="Transaction in JSON format")
+parser.add_argument('--raw', action='store_true', help="Send plain EOS serialization instead of DER fields")
+parser.add_argument('--names', action='store_true', help="Send plain EOS serialization with repeated names as references")
+parser.add_argument('--manifest', action='store_true', help="Send the pre-flight manifest before the transaction")
+parser.add_argument('--retries', type=int, default=0, help="Reconnect and resume this many times after a transport error")
 args = parser.parse_args()
 
 if args.path is None:
@@ -43,10 +47,25 @@ pathSize = len(donglePath) // 4
 with open(args.file) as f:
     obj = json.load(f)
     tx = Transaction.parse(obj)
-    tx_chunks = tx.encode2()
+    if args.names:
+        tx_chunks = tx.encode_raw_names()
+        p2 = "02"
+    elif args.raw:
+        tx_chunks = tx.encode_raw()
+        p2 = "01"
+    else:
+        tx_chunks = tx.encode2()
+        p2 = "00"
 
     first = True
+    sequence = 0
+    retries = args.retries
     dongle = getDongle(True)
+    if args.manifest:
+        # Unsupported transactions are refused here, before anything is streamed
+        manifest = tx.manifest()
+        apdu = bytearray.fromhex("D40403" + p2) + bytes([len(manifest)]) + manifest
+        dongle.exchange(bytes(apdu))
     for tx_chunk in tx_chunks:
 
         offset = 0
@@ -60,12 +79,24 @@ with open(args.file) as f:
 
             if first:
                 totalSize = len(donglePath) + 1 + len(transport_chunk)
-                apdu = bytearray.fromhex("D4040000") + bytes([totalSize, pathSize]) + donglePath + transport_chunk
+                apdu = bytearray.fromhex("D40400" + p2) + bytes([totalSize, pathSize]) + donglePath + transport_chunk
                 first = False
             else:
                 totalSize = len(transport_chunk)
-                apdu = bytearray.fromhex("D4048000") + bytes([totalSize]) + transport_chunk
+                apdu = bytearray.fromhex("D40480" + p2) + bytes([totalSize]) + transport_chunk
 
             offset += len(transport_chunk)
-            result = dongle.exchange(bytes(apdu))
+            while True:
+                try:
+                    result = dongle.exchange(bytes(apdu))
+                    break
+                except (IOError, OSError):
+                    if retries == 0:
+                        raise
+                    retries -= 1
+                    # The device keeps the transaction, resend this chunk with its sequence number
+                    dongle = getDongle(True)
+                    apdu = bytearray.fromhex("D40402" + p2) + bytes([len(transport_chunk) + 2]) + \
+                        struct.pack('>H', sequence) + transport_chunk
+            sequence += 1
             print(binascii.hexlify(result))
\ No newline at end of file
@@ -0,0 +1,47 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Taras Shchybovyk
+*   (c) 2018 Taras Shchybovyk
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+Uploads the descriptor of one action of a contract ABI. The hash printed
+here must match the one shown on the device before approving it.
+"""
+
+import hashlib
+import os
+import sys
+from ledgerblue.comm import getDongle
+import argparse
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'src'))
+import gen_actions
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--abi', default='abi/fairygame111.json', help="Contract ABI in JSON format")
+parser.add_argument('--contract', help="Contract account, the ABI file name by default")
+parser.add_argument('--action', default='play', help="Action to describe")
+args = parser.parse_args()
+
+if args.contract is None:
+    args.contract = os.path.splitext(os.path.basename(args.abi))[0]
+
+descriptor = gen_actions.descriptor(args.abi, args.contract, args.action)
+print("Hash: " + hashlib.sha256(descriptor).hexdigest())
+
+dongle = getDongle(True)
+apdu = bytearray.fromhex("D40A0000") + bytes([len(descriptor)]) + descriptor
+dongle.exchange(bytes(apdu))